@@ -0,0 +1,68 @@
+/*
+ * FileCommand - Execute programs stored in the LittleFS filesystem.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __FILECOMMAND_H__
+#define __FILECOMMAND_H__
+
+#include "Command.h"
+#include "MotionSegment.h"
+#include <LittleFS.h>
+
+// Number of motion commands parsed ahead of the motion queue
+#define FILE_PREFETCH (4)
+
+/* play() result */
+#define FILE_PLAY_OK       (0)
+#define FILE_PLAY_NO_FILE  (-1)
+#define FILE_PLAY_INVALID  (-2)
+
+/*!
+ * \brief Binary program callbacks, return: 1 - accepted, 0 - busy (try again later), -1 - error.
+ */
+typedef std::function<int(const motion_program_hdr_t *h)> ProgramHeaderCB;
+typedef std::function<int(const motion_segment_t *s)>     ProgramSegmentCB;
+
+class FileCommand: public Command {
+public:
+	FileCommand(CommandDB *db): Command(db), m_owner(NULL), m_prog(-1), m_binary(false), m_segValid(false), m_segNo(0) {}
+
+	/*!
+	 * \brief Only errors are passed to the command channel that started the program.
+	 */
+	virtual void print(String s) {
+		if ((m_owner) && (s[0] == '!')) {
+			m_owner->print(s);
+		}
+		cmddebug(s);
+	}
+	virtual void loop();
+	int play(int prog, Command *owner);
+	void stopPlay();
+	bool isPlaying() {return (m_prog >= 0);}
+	void list(CommandQueueItem *c);
+
+	void onBinary(ProgramHeaderCB hcb, ProgramSegmentCB scb) {m_headerCb = hcb; m_segmentCb = scb;}
+
+	static String programName(int prog, bool binary = false) {return "/p" + String(prog) + ((binary) ? ".b" : ".g");}
+	static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len);
+	static uint32_t fileCrc32(File &f);
+public:
+	File       m_file;
+	Command   *m_owner;                    // Command channel that started the program
+	int        m_prog;                     // Program number (-1 - not playing)
+	/* Binary program */
+	bool             m_binary;             // Binary program is played
+	motion_segment_t m_seg;                // Segment waiting for free space in the motion queue
+	bool             m_segValid;
+	uint32_t         m_segNo;              // Current segment number
+	ProgramHeaderCB  m_headerCb;
+	ProgramSegmentCB m_segmentCb;
+};
+
+#endif //__FILECOMMAND_H__
@@ -13,6 +13,7 @@
 #include "Command.h"
 #include <ESPAsyncTCP.h>
 #include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
 
 
 class HTTPCommand: public Command {
@@ -28,9 +29,15 @@ public:
 	}
 	virtual void readSerial() {};
 	void handleData(const char *data, int len);
+	void handleUpload(AsyncWebServerRequest *request, size_t index, uint8_t *data, size_t len, bool final);
 public:
 	AsyncWebServer   *m_server;
 	AsyncEventSource *m_events;
+	/* Program upload */
+	File              m_uploadFile;
+	uint32_t          m_uploadCrc;
+	bool              m_uploadOk;
+	bool              m_uploadBinary;
 };
 
 #endif // __HTTPCOMMAND_H__
@@ -18,6 +18,8 @@
 #include <ets_sys.h>
 #include "osapi.h"
 #include "Command.h"
+#include "MotionSegment.h"
+#include "Planner.h"
 
 extern volatile int               x_target;
 extern volatile int               x_pos;
@@ -25,15 +27,82 @@ extern volatile int               x_pos;
 
 #define MOTION_QUEUE_SIZE (64)
 
+/* Curve (easing) segments */
+#define CURVE_TICK_US     (10000)             /*!< Curve interpolation period in [us].      */
+
+/* Program loops */
+#define MOTION_LOOP_DEPTH (4)                 /*!< Maximum loop nesting.                    */
+
+/* Microstep resolution (positions are kept in 1/256 microsteps - the TMC2208 MSCNT unit) */
+#define MICROSTEP_FINE     (256)              /*!< Position unit in [1/microsteps].         */
+#define MICROSTEP_AUTO_MIN (8)                /*!< Coarsest automatic resolution.           */
+#define MSCNT_CYCLE        (1024)             /*!< MSCNT period (4 full steps) in 1/256 microsteps. */
+
+/* Hybrid cruise - long cruise phases are run by the TMC2208 internal step generator (VACTUAL) */
+#define HYBRID_MIN_MS      (1000)             /*!< Minimum cruise time handed to the driver. */
+#define HYBRID_HANDBACK_US (20000)            /*!< STEP pulses take over before the brake point. */
+#define HYBRID_SETTLE_MS   (20)               /*!< Standstill before the final MSCNT readback. */
+#define VACTUAL_CLOCK      (12000000)         /*!< TMC2208 internal clock in [Hz] (VACTUAL time base). */
+#define HYBRID_SPEED_ERR   (5)                /*!< Worst-case VACTUAL speed error (driver clock) in [%]. */
+#define HYBRID_GAP_US      (20000)            /*!< Longest MSCNT sample gap, the STEP pulses take over when exceeded. */
+#define HYBRID_TRACK_ERR   (MSCNT_CYCLE / 4)  /*!< Allowed prediction error (MSCNT unwraps within a half cycle). */
+#define HYBRID_RETRIES     (3)                /*!< VACTUAL = 0 writes before the driver is given up. */
+#define HYBRID_OFF         (0)
+#define HYBRID_RAMP        (1)                /*!< STEP pulses ramp up to the cruise speed. */
+#define HYBRID_HANDOFF     (2)                /*!< VACTUAL write in progress.               */
+#define HYBRID_VACTUAL     (3)                /*!< Driver runs, position tracked by MSCNT.  */
+#define HYBRID_HANDBACK    (4)                /*!< STEP pulses again (brake and approach).  */
+#define HYBRID_FINAL       (5)                /*!< Standstill - MSCNT correction.           */
+
+/* Homing cycle (MOTION_CMD_HOME) */
+#define HOME_BACKOFF       (50 * MICROSTEP_FINE)  /*!< Back-off after the fast approach (50 full steps). */
+#define HOME_SLOW_SPEED    (25 * MICROSTEP_FINE)  /*!< Slow approach in [1/256 microsteps/s] (below start/stop speed at any resolution). */
+#define HOME_OFF           (0)
+#define HOME_SEEK          (1)                /*!< Fast approach to the endstop.            */
+#define HOME_BACK          (2)                /*!< Back-off from the switch.                */
+#define HOME_SLOW          (3)                /*!< Slow approach, stop at the trigger step. */
+/* Homing result */
+#define HOME_OK            (0)
+#define HOME_NOT_FOUND     (1)                /*!< Endstop not triggered.                   */
+#define HOME_NOT_RELEASED  (2)                /*!< Endstop still active after the back-off. */
+#define HOME_CANCELLED     (3)                /*!< Stopped by STP/SST.                      */
+
+/* Quadrature encoder (closed loop) */
+#define ENC_DEADBAND       (MICROSTEP_FINE)       /*!< Default end-of-move error left uncorrected (1 full step). */
+#define ENC_FOLLOW_MAX     (8 * MICROSTEP_FINE)   /*!< Default following error limit (8 full steps).  */
+#define ENC_CORRECT_TRIES  (2)                /*!< Correction moves after one move.         */
+#define ENC_INVALID        (2)                /*!< Decoder table - both channels changed.   */
+
+/* Position-indexed speed map */
+#define SPEED_MAP_SIZE    (8)                 /*!< Maximum number of (position, speed) knots. */
+
+/* Step rate self-test result (in timer1 clock cycles) */
+typedef struct motion_rate_s {
+	uint32_t late;                            /*!< Late timer interrupts (missed edges).    */
+	uint32_t max_interval;                    /*!< Maximum interval between interrupts.     */
+	uint32_t max_isr;                         /*!< Maximum interrupt handler duration.      */
+} motion_rate_t;
+
 #ifdef MOTION_QUEUE_SIZE
 #define MOTION_QUEUE_MASK (MOTION_QUEUE_SIZE-1)
+
 typedef struct motion_queue_s {
 	int cmd;
 	int duration;
-	int x;
+	int x;                                    /*!< Distance in 1/256 microsteps.            */
+	int arg;                                  /*!< Command argument (curve control points, user resolution of moves). */
 } motion_queue_t;
 #endif
 
+/*! Driver resolution change (called at standstill only), the driver confirms it with resolutionDone(). */
+typedef void (*ResolutionCB)(int microsteps);
+/*! Write driver VACTUAL (0 - STEP input), result is passed to velocityDone(), return false when not queued. */
+typedef boolean (*VelocityCB)(int vactual);
+/*! Read driver MSCNT, result is passed to hybridMscnt(), return false when not queued. */
+typedef boolean (*MscntReadCB)(void);
+/*! Homing cycle finished (HOME_OK ...). */
+typedef void (*HomeCB)(int result);
+
 class Motion1D
 {
 public:
@@ -45,60 +114,265 @@ public:
 	
 	boolean loop();
 	boolean isInMotion();
-	void goToReal(int duration, int xSteps);
+	void goToReal(int duration, int dx);
+	void startMove(int dx, uint32_t hperiod, boolean useMap = false);
+	void moveStart(int end, uint64_t fperiod);
+	void movePiece();
+	void jog(int speed, int limit, int timeout);
+	boolean isJogging() {return m_jogActive;}
 
 
 #ifdef MOTION_QUEUE_SIZE
-	void goTo(uint16_t duration, int xSteps) {motionQ_push(1, duration, xSteps);}
+	/*!
+	 * \brief Queue move of dx (in 1/256 microsteps, multiple of the user resolution) in duration [ms].
+	 */
+	void goTo(uint16_t duration, int dx) {motionQ_push(MOTION_CMD_GOTO, duration, dx, m_unitShift);}
+	/*!
+	 * \brief Queue precompiled move (cruise half period in clock cycles per user microstep).
+	 */
+	void goToPeriod(uint32_t hperiod, int dx) {motionQ_push(MOTION_CMD_MOVE, hperiod, dx, m_unitShift);}
+	/*!
+	 * \brief Queue curve segment - cubic Bezier easing in time with control ordinates p1, p2 (in [1/1000]).
+	 */
+	void goCurve(int duration, int dx, int p1, int p2) {motionQ_push(MOTION_CMD_CURVE, duration, dx, (p1 << 16) | p2);}
+
+	/*!
+	 * \brief Queue move with speed taken from the position-indexed speed map.
+	 */
+	void goMap(int dx) {motionQ_push(MOTION_CMD_MAP, 0, dx);}
 
-	void motionQ_push(int cmd, int duration, int x) {
+	/*!
+	 * \brief Queue homing cycle - seek the endstop up to dx (in 1/256 microsteps) at speed [1/256 microsteps/s],
+	 * the latched position becomes zero, the result is passed to the onHome() callback.
+	 */
+	void goHome(int dx, int speed) {motionQ_push(MOTION_CMD_HOME, speed, dx);}
+
+	/*!
+	 * \brief Queue hardware timed dwell (in [ms]).
+	 */
+	void dwell(int duration) {motionQ_push(MOTION_CMD_DWELL, duration, 0);}
+	boolean loopBegin(int count);
+	boolean loopEnd();
+	void loopCancel();
+
+	void motionQ_push(int cmd, int duration, int x, int arg = 0) {
 		int pos = m_motionQWr;
 		motion_queue_t *v = &m_motionQ[pos];
 		v->cmd = cmd;
 		v->duration = duration;
 		v->x = x;
+		v->arg = arg;
 		pos++;
 		pos &= MOTION_QUEUE_MASK;
 		m_motionQWr = pos;
 	}
 	
 	uint32_t motionQ_is_full() {
+		/* Running loop keeps its body in the queue */
+		int tail = (m_loopLevel) ? m_loopBegin[0] : m_motionQRd;
 		int pos = m_motionQWr;
 		pos++;
 		pos &= MOTION_QUEUE_MASK;
-		if (pos == m_motionQRd) return 1;
+		if (pos == tail) return 1;
 		pos++;
 		pos &= MOTION_QUEUE_MASK;
-		if (pos == m_motionQRd) return 1;
+		if (pos == tail) return 1;
 		return 0;
 	}
 	
-	void motionQ_pull() {
-		if (m_motionQWr != m_motionQRd) {
-			int pos = m_motionQRd;
-			motion_queue_t *v = &m_motionQ[pos];
-			switch (v->cmd) {
-				case 1: goToReal(v->duration, v->x); break;
-				default: break;
-			}
-			pos++;
-			pos &= MOTION_QUEUE_MASK;
-			m_motionQRd = pos;
-		}
-	}
+	void motionQ_pull();
 #else
-	void goTo(int duration, int xSteps) {goToReal(duration, xSteps);}
+	void goTo(int duration, int dx) {goToReal(duration, dx);}
 #endif
+	void dwellStart(int duration);
+	void mapClear();
+	boolean mapEmpty();
+	boolean mapAdd(int pos, int speed);
+	void mapStart(int dx);
+	void curveStart(int duration, int dx, int p1, int p2);
+	void curveLoop();
+	void curveToRamp();
 	void stop();
+	void softStop();
+	void brake();
+	void pause();
+	void resume();
+	boolean isPaused() {return m_paused;}
+	void setOverride(int percent);
+	void setMicrosteps(int microsteps);
+	static int unitShift(int microsteps);
+	void setResolution(int shift);
+	int segmentShift(int dx);
+	void setAutoMicrosteps(boolean enable);
+	void onResolution(ResolutionCB cb) {m_onResolution = cb;}
+	/*!
+	 * \brief Driver resolution was changed - a move waiting for it may start.
+	 */
+	void resolutionDone() {m_resWait = 0;}
+	int position();
+	int target();
+	/*!
+	 * \brief Convert [microsteps] (user resolution) to position units (1/256 microsteps).
+	 */
+	int fromMicrosteps(int steps) {return steps * (1 << m_unitShift);}
+	/*!
+	 * \brief User resolution in [microsteps per step].
+	 */
+	int microsteps() {return MICROSTEP_FINE >> m_unitShift;}
+	void setZero();
+	void setZeroAt(int pos);
+	void endstopBegin(int pin, int level = LOW);
+	boolean endstopActive();
+	void onHome(HomeCB cb) {m_onHome = cb;}
+	/*!
+	 * \brief Single pass homing - the seek result is the zero point (sensorless homing, no back-off pass).
+	 */
+	void setHomeSingle(boolean single) {m_homeSingle = single;}
+	void stallDetect(boolean enable);
+	boolean stallHit(int *pos);
+	void encoderBegin(int pinA, int pinB);
+	void setEncoder(int units, int counts, int deadband, int limit);
+	/*!
+	 * \brief Encoder feedback is enabled.
+	 */
+	boolean isEncoder() {return (m_encCounts != 0);}
+	int encoderPosition();
+	void encoderSync();
+	void encoderMonitor();
+	boolean encoderCorrect();
+	boolean encoderFault(int *err);
+	uint32_t encoderInvalid();
+	void homeStart(int dx, int speed);
+	void homeNext();
+	void homeZero();
+	void homeDone(int result);
+	/*!
+	 * \brief Homing cycle is running.
+	 */
+	boolean isHoming() {return (m_home != HOME_OFF);}
+	void endstopArm();
+	void endstopDisarm();
+	boolean endstopHit();
+	int endstopPos();
+	/*!
+	 * \brief Driver MSCNT expected at the current position.
+	 */
+	int mscntExpected() {return (x_pos + m_phase) & (MSCNT_CYCLE - 1);}
+	void mscntSync(int mscnt);
+	int mscntCheck(int mscnt);
+	/*!
+	 * \brief Enable hybrid cruise (cruise phase of long moves runs from the driver VACTUAL).
+	 */
+	void setHybrid(boolean enable) {m_hybridEnable = enable;}
+	void onHybrid(VelocityCB vcb, MscntReadCB mcb) {m_onVelocity = vcb; m_onMscntRead = mcb;}
+	/*!
+	 * \brief Driver VACTUAL write done (ok - the driver received it, IFCNT incremented).
+	 */
+	void velocityDone(boolean ok) {m_hybridVOk = ok; m_hybridVDone = 1;}
+	void hybridMscnt(boolean ok, int mscnt, uint32_t t);
+	void hybridStart(int dx, uint32_t hperiod);
+	boolean hybridLoop();
+	void hybridHandback();
+	boolean isHybrid() {return (m_hybrid != HYBRID_OFF);}
+	boolean hybridFault();
+	boolean rateTest(uint32_t hperiod, int steps, motion_rate_t *r, int room = 0);
 	void printStat(CommandQueueItem *c);
 public:
 	int           m_x_dir;
 	boolean       m_motorsEnabled;
 	int           m_en_pin;
+	/* Velocity (jog) mode */
+	boolean       m_jogActive;      /*!< Jog mode is active.                               */
+	int           m_jogSpeed;       /*!< Requested speed in [microsteps/s] (signed).       */
+	int           m_jogLimit;       /*!< Position limit in the requested direction (1/256). */
+	uint32_t      m_jogDeadline;    /*!< Dead-man timeout (millis) - brake when expired.   */
+	/* Feed-rate override */
+	int           m_override;       /*!< Speed override in [%] (100 - programmed speed).   */
+	uint32_t      m_cruiseHperiod;  /*!< Programmed (not overridden) half period.          */
+	/* Curve segment */
+	boolean       m_curveActive;    /*!< Curve segment is executed.                        */
+	int           m_curveX0;        /*!< Curve start position (1/256).                     */
+	int           m_curveDelta;     /*!< Curve length in 1/256 microsteps (signed).        */
+	int           m_curveP1;        /*!< First control ordinate (Q16).                     */
+	int           m_curveP2;        /*!< Second control ordinate (Q16).                    */
+	uint64_t      m_curveT;         /*!< Curve time in [us] (scaled by feed-rate override). */
+	uint64_t      m_curveDuration;  /*!< Curve duration in [us].                           */
+	uint32_t      m_curveLast;      /*!< Last interpolation tick (micros).                 */
+	uint32_t      m_curveNext;      /*!< Next interpolation tick (micros).                 */
+	/* Pause/resume */
+	boolean       m_paused;         /*!< Queue is paused.                                  */
+	int           m_pauseTarget;    /*!< Target of the interrupted segment.                */
+	uint32_t      m_pauseHperiod;   /*!< Cruise half period of the interrupted segment.    */
+	boolean       m_pauseMap;       /*!< Interrupted segment uses the speed map.           */
+	/* Microstep resolution */
+	int           m_unitShift;      /*!< User resolution (1/256 microsteps per microstep). */
+	boolean       m_autoMs;         /*!< Automatic resolution of moves.                    */
+	ResolutionCB  m_onResolution;   /*!< Set driver resolution.                            */
+	int           m_phase;          /*!< Driver MSCNT at position 0.                       */
+	boolean       m_resWait;        /*!< Driver resolution change is in progress.          */
+	boolean       m_startWait;      /*!< Move is prepared, timer waits for the driver.     */
+	/* Lost-step detection (MSCNT readback) */
+	uint32_t      m_lostCount;      /*!< Detected MSCNT mismatches.                        */
+	int           m_lostLast;       /*!< Last mismatch in 1/256 microsteps (signed).       */
+	boolean       m_lostPause;      /*!< Pause the queue on mismatch.                      */
+	/* Hybrid cruise (VACTUAL) */
+	boolean       m_hybridEnable;   /*!< Hybrid cruise is enabled.                         */
+	int           m_hybrid;         /*!< Hybrid state (HYBRID_OFF ...).                    */
+	int           m_hybridEnd;      /*!< End of the hybrid move.                           */
+	int           m_hybridHand;     /*!< STEP pulses take over at this position.           */
+	uint32_t      m_hybridH;        /*!< Cruise half period.                               */
+	int64_t       m_hybridV;        /*!< Speed in 1/256 microsteps per [us] (Q16, signed). */
+	int           m_hybridX;        /*!< Last tracked position.                            */
+	uint32_t      m_hybridT;        /*!< Time of m_hybridX (micros).                       */
+	int           m_hybridX0;       /*!< First tracked position (speed measurement base). */
+	uint32_t      m_hybridT0;       /*!< Time of m_hybridX0 (micros).                      */
+	int           m_hybridN;        /*!< Tracked MSCNT samples.                            */
+	boolean       m_hybridVDone;    /*!< VACTUAL write done.                               */
+	boolean       m_hybridVOk;      /*!< VACTUAL write confirmed by the driver.            */
+	int           m_hybridTries;    /*!< VACTUAL = 0 writes not confirmed.                 */
+	uint32_t      m_hybridMoveT;    /*!< Tracked position advanced last time (micros).     */
+	boolean       m_hybridLost;     /*!< Tracking lost (stall or too long sample gap).     */
+	boolean       m_hybridFault;    /*!< Unreported tracking loss.                         */
+	boolean       m_hybridVSent;    /*!< VACTUAL write queued.                             */
+	boolean       m_hybridRead;     /*!< MSCNT read in progress.                           */
+	uint32_t      m_hybridStop;     /*!< Standstill since (millis).                        */
+	VelocityCB    m_onVelocity;     /*!< Write driver VACTUAL.                             */
+	MscntReadCB   m_onMscntRead;    /*!< Read driver MSCNT.                                */
+	/* Homing cycle */
+	int           m_home;           /*!< Homing state (HOME_OFF ...).                      */
+	int           m_homeDir;        /*!< Seek direction (1, -1).                           */
+	uint64_t      m_homeFast;       /*!< Seek and back-off period per 1/256 microstep (Q8). */
+	int           m_endPin;         /*!< Endstop pin (-1 - none).                          */
+	int           m_endLevel;       /*!< Endstop active level.                             */
+	boolean       m_homeSingle;     /*!< Single pass homing.                               */
+	HomeCB        m_onHome;         /*!< Homing finished.                                  */
+	/* Quadrature encoder */
+	int           m_encUnits;       /*!< Scale - 1/256 microsteps per m_encCounts.         */
+	int           m_encCounts;      /*!< Scale - encoder counts (0 - disabled, < 0 - reversed). */
+	int           m_encOffset;      /*!< Position at encoder count 0.                      */
+	int           m_encDeadband;    /*!< End-of-move error left uncorrected.               */
+	int           m_encLimit;       /*!< Following error limit.                            */
+	boolean       m_encCheck;       /*!< Queued move ended - compare with the encoder.     */
+	int           m_encTries;       /*!< Correction moves after the current move.          */
+	uint32_t      m_encCorrections; /*!< Correction moves.                                 */
+	int           m_encLast;        /*!< Last corrected error in 1/256 microsteps.         */
+	uint32_t      m_encFaults;      /*!< Following error faults.                           */
+	int           m_encFault;       /*!< Following error not reported yet (0 - none).      */
+	/* Move split into resolution aligned pieces */
+	boolean       m_moveSplit;      /*!< Move has pieces left.                             */
+	int           m_moveEnd;        /*!< Move end position.                                */
+	uint64_t      m_movePeriod;     /*!< Period per 1/256 microstep (Q8).                  */
+	int           m_moveShift;      /*!< Resolution selected for the move.                 */
 #ifdef MOTION_QUEUE_SIZE
 	motion_queue_t m_motionQ[MOTION_QUEUE_SIZE];
 	int            m_motionQWr;
 	int            m_motionQRd;
+	/* Loops */
+	int            m_loopOpen[MOTION_LOOP_DEPTH];   /*!< Queued loop begin entries waiting for loop end. */
+	int            m_loopOpenN;
+	int            m_loopBegin[MOTION_LOOP_DEPTH];  /*!< Running loops - loop begin entry.             */
+	int            m_loopCount[MOTION_LOOP_DEPTH];  /*!< Running loops - iterations left (0 - forever). */
+	int            m_loopLevel;
 #endif
 };
 
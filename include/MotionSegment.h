@@ -0,0 +1,62 @@
+/*
+ * Compact precompiled motion segments - shared by the firmware and host tools (pc/).
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __MOTION_SEGMENT_H__
+#define __MOTION_SEGMENT_H__
+
+#include <stdint.h>
+
+/* Motion queue commands (also binary segment types) */
+#define MOTION_CMD_GOTO   (1)                 /*!< Move, duration in [ms].                  */
+#define MOTION_CMD_CURVE  (2)                 /*!< Curve, duration in [ms], arg = p1<<16|p2. */
+#define MOTION_CMD_MAP    (3)                 /*!< Move with speed from the speed map.      */
+#define MOTION_CMD_DWELL  (4)                 /*!< Dwell, duration in [ms].                 */
+#define MOTION_CMD_LOOP   (5)                 /*!< Loop begin (duration = count, 0 - infinite). */
+#define MOTION_CMD_ENDL   (6)                 /*!< Loop end.                                */
+#define MOTION_CMD_NOP    (7)                 /*!< Cancelled entry.                         */
+#define MOTION_CMD_MOVE   (8)                 /*!< Move, precompiled cruise half period.    */
+#define MOTION_CMD_HOME   (9)                 /*!< Homing cycle, x = seek distance, duration = speed (queue only). */
+
+/* Binary program file */
+#define SEGMENT_MAGIC     (0x31424c53)        /*!< "SLB1"                                   */
+#define SEGMENT_VERSION   (1)
+#define SEGMENT_FILE_ZERO (1)                 /*!< Set position to zero before start (G90). */
+#define SEGMENT_NO_LIMIT  (1)                 /*!< Segment flag - do not check limits (UM). */
+
+/*!
+ * \brief Binary program header.
+ */
+typedef struct motion_program_hdr_s {
+	uint32_t magic;                           /*!< SEGMENT_MAGIC.                           */
+	uint16_t version;                         /*!< SEGMENT_VERSION.                         */
+	uint16_t flags;                           /*!< SEGMENT_FILE_*.                          */
+	uint16_t microsteps;                      /*!< Microsteps per step used by the program. */
+	uint16_t current;                         /*!< Motor current in [mA] (0 - do not change). */
+	int32_t  start;                           /*!< Start position in [microsteps].          */
+	uint32_t count;                           /*!< Number of segments.                      */
+} motion_program_hdr_t;
+
+/*!
+ * \brief Binary motion segment (little endian, the same layout on the host and ESP8266).
+ */
+typedef struct motion_segment_s {
+	uint8_t  type;                            /*!< MOTION_CMD_*.                            */
+	uint8_t  flags;                           /*!< SEGMENT_*.                               */
+	uint16_t reserved;                        /*!< Reserved (0).                            */
+	int32_t  steps;                           /*!< Move length in [microsteps] (signed).    */
+	uint32_t value;                           /*!< Half period (MOVE), duration in [ms] (CURVE, DWELL), count (LOOP). */
+	uint32_t arg;                             /*!< Curve control ordinates p1<<16|p2.       */
+} motion_segment_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(motion_program_hdr_t) == 20, "motion_program_hdr_t layout");
+static_assert(sizeof(motion_segment_t) == 16, "motion_segment_t layout");
+#endif
+
+#endif //__MOTION_SEGMENT_H__
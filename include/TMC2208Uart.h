@@ -0,0 +1,177 @@
+/*
+ * Asynchronous TMC2208 single wire UART register access.
+ * Build with DRIVER_TMC2209 for the pin compatible TMC2209 (slave address set by MS1/MS2,
+ * StallGuard4 registers, stall output on the DIAG pin).
+ * Register reads/writes are queued and executed by a state machine polled from the main loop,
+ * so neither the command processing nor the motion queue refill waits for the driver.
+ * Configuration registers are kept in a RAM shadow, changed registers are written once per
+ * main loop pass and periodically compared with the chip.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __TMC2208_UART_H__
+#define __TMC2208_UART_H__
+
+#include "Arduino.h"
+#include <stdint.h>
+#include <functional>
+#include "Command.h"
+
+#define TMC_QUEUE_SIZE    (16)                /*!< Queued transactions (power of 2).        */
+#define TMC_QUEUE_MASK    (TMC_QUEUE_SIZE-1)
+#define TMC_BAUD          (115200)
+#define TMC_TIMEOUT_US    (5000)              /*!< Reply timeout.                           */
+#define TMC_RETRIES       (2)                 /*!< Retries of a failed transaction.         */
+#define TMC_CHECK_MS      (1000)              /*!< Shadow integrity check period.           */
+#ifdef DRIVER_TMC2209
+#define TMC_SHADOW_N      (8)                 /*!< Shadowed configuration registers.        */
+#else
+#define TMC_SHADOW_N      (6)                 /*!< Shadowed configuration registers.        */
+#endif
+#define TMC_FCLK          (12000000)          /*!< Internal clock in [Hz] (TSTEP time base). */
+#define TPWMTHRS_MAX      (0xFFFFF)
+#define TMC_HOLD_PERCENT  (50)                /*!< Default hold current in [%] of run current. */
+#define TMC_IHOLDDELAY    (4)                 /*!< Smooth run to hold current transition.   */
+
+/* Datagrams */
+#define TMC_SYNC          (0x05)
+#define TMC_MASTER_ADDR   (0xFF)
+#define TMC_WRITE         (0x80)
+
+/* Registers */
+#define TMC_GCONF         (0x00)
+#define TMC_GSTAT         (0x01)
+#define TMC_IFCNT         (0x02)
+#define TMC_IHOLD_IRUN    (0x10)
+#define TMC_TPOWERDOWN    (0x11)
+#define TMC_TSTEP         (0x12)
+#define TMC_TPWMTHRS      (0x13)
+#define TMC_TCOOLTHRS     (0x14)              /*!< TMC2209 - StallGuard/DIAG enabled above this speed. */
+#define TMC_VACTUAL       (0x22)
+#define TMC_SGTHRS        (0x40)              /*!< TMC2209 - stall when SG_RESULT <= 2 * SGTHRS. */
+#define TMC_SG_RESULT     (0x41)              /*!< TMC2209 - StallGuard load (0 - highest load). */
+#define TMC_MSCNT         (0x6A)
+#define TMC_CHOPCONF      (0x6C)
+#define TMC_DRV_STATUS    (0x6F)
+#define TMC_PWMCONF       (0x70)
+
+/* GSTAT */
+#define GSTAT_RESET            (1u << 0)
+/* GCONF */
+#define GCONF_I_SCALE_ANALOG   (1u << 0)
+#define GCONF_EN_SPREADCYCLE   (1u << 2)
+#define GCONF_PDN_DISABLE      (1u << 6)
+#define GCONF_MSTEP_REG_SELECT (1u << 7)
+/* CHOPCONF */
+#define CHOPCONF_TOFF_MASK     (0xFu << 0)
+#define CHOPCONF_VSENSE        (1u << 17)
+#define CHOPCONF_MRES_SHIFT    (24)
+#define CHOPCONF_MRES_MASK     (0xFu << CHOPCONF_MRES_SHIFT)
+#define CHOPCONF_INTPOL        (1u << 28)
+/* IHOLD_IRUN */
+#define IHOLD_IRUN(ihold, irun, delay) (((uint32_t)(delay) << 16) | ((uint32_t)(irun) << 8) | (uint32_t)(ihold))
+#define IHOLD_MASK             (0x1Fu << 0)
+#define IRUN_MASK              (0x1Fu << 8)
+#define IHOLDDELAY_MASK        (0xFu << 16)
+/* PWMCONF */
+#define PWMCONF_AUTOSCALE      (1u << 18)
+
+/* Transaction types */
+#define TMC_OP_READ       (0)
+#define TMC_OP_WRITE      (1)
+#define TMC_OP_MODIFY     (2)                 /*!< Read, change masked bits and write back. */
+
+/*!
+ * \brief Transaction done callback (ok - CRC checked reply received / datagram sent, value - register value).
+ */
+typedef std::function<void(bool ok, uint32_t value)> TMCDoneCB;
+
+typedef struct tmc_transaction_s {
+	uint8_t   op;
+	uint8_t   reg;
+	uint32_t  value;
+	uint32_t  mask;                           /*!< Changed bits (TMC_OP_MODIFY).            */
+	TMCDoneCB cb;
+} tmc_transaction_t;
+
+class TMC2208Uart
+{
+public:
+	TMC2208Uart(Stream *serial, float rsense, uint8_t addr = 0);
+
+	bool read(uint8_t reg, TMCDoneCB cb);
+	bool write(uint8_t reg, uint32_t value, TMCDoneCB cb = NULL);
+	bool modify(uint8_t reg, uint32_t mask, uint32_t value, TMCDoneCB cb = NULL);
+	void begin();
+	void set(uint8_t reg, uint32_t mask, uint32_t value, TMCDoneCB cb = NULL);
+	uint32_t get(uint8_t reg);
+	void rmsCurrent(uint16_t mA, TMCDoneCB cb = NULL);
+	void microsteps(uint16_t ms, TMCDoneCB cb = NULL);
+	void stealthChop(int speed, TMCDoneCB cb = NULL);
+	void holdCurrent(int percent, int settleMs, TMCDoneCB cb = NULL);
+#ifdef DRIVER_TMC2209
+	void stallGuard(int threshold, int speed, TMCDoneCB cb = NULL);
+#endif
+	void loop();
+	/*!
+	 * \brief No transaction is queued or running.
+	 */
+	bool idle() {return (m_state == TMC_STATE_IDLE) && (m_rd == m_wr);}
+	/*!
+	 * \brief At least n transactions can be queued.
+	 */
+	bool room(int n) {return ((m_rd - m_wr - 1) & TMC_QUEUE_MASK) >= n;}
+	void printStat(CommandQueueItem *c);
+
+	static uint8_t crc8(const uint8_t *data, int len);
+	static uint32_t mres(uint16_t ms);
+	static int shadowIndex(uint8_t reg);
+private:
+	enum {TMC_STATE_IDLE, TMC_STATE_SEND, TMC_STATE_REPLY};
+	bool push(uint8_t op, uint8_t reg, uint32_t value, uint32_t mask, TMCDoneCB cb);
+	void start();
+	void done(bool ok, uint32_t value);
+	void fail();
+	void shadowFlush();
+	void shadowCheck();
+	void shadowLoaded(int i, bool ok, uint32_t v);
+public:
+	Stream            *m_serial;
+	float              m_rsense;
+	uint8_t            m_addr;
+	tmc_transaction_t  m_q[TMC_QUEUE_SIZE];
+	int                m_rd;
+	int                m_wr;
+	int                m_state;
+	uint8_t            m_reading;         /*!< Read phase of the running transaction.           */
+	uint32_t           m_value;           /*!< Value written by the running transaction.        */
+	int                m_retry;
+	uint32_t           m_t0;              /*!< Datagram start (micros).                         */
+	uint32_t           m_txTime;          /*!< Datagram transmission time in [us].              */
+	uint8_t            m_rx[8];           /*!< Reply (sync, master address, register, data, CRC). */
+	int                m_rxN;
+	/* Statistics */
+	uint32_t           m_reads;
+	uint32_t           m_writes;
+	uint32_t           m_crcErrors;
+	uint32_t           m_timeouts;
+	uint32_t           m_failed;          /*!< Transactions failed after all retries.           */
+	/* Shadow registers */
+	uint32_t           m_shadow[TMC_SHADOW_N];
+	uint32_t           m_touched[TMC_SHADOW_N];  /*!< Bits set before the shadow was loaded.    */
+	TMCDoneCB          m_shadowCb[TMC_SHADOW_N]; /*!< Called when the register is written.      */
+	uint32_t           m_dirty;           /*!< Registers to write (bit mask of shadow index).   */
+	uint32_t           m_busy;            /*!< Registers with a queued write.                   */
+	uint32_t           m_loading;         /*!< Registers read at startup.                       */
+	uint32_t           m_checkT;          /*!< Last integrity check (millis).                   */
+	int                m_checkIdx;        /*!< Next register compared with the chip.            */
+	uint32_t           m_mismatch;        /*!< Shadow and chip differed (register rewritten).   */
+	uint32_t           m_resets;          /*!< Driver reset detected (GSTAT.reset).             */
+	int                m_holdPercent;     /*!< Hold current in [%] of run current.              */
+};
+
+#endif //__TMC2208_UART_H__
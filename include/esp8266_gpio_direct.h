@@ -12,4 +12,9 @@ struct gpio_regs {
 	uint32_t status_w1tc; /* 0x60000324 */
 };
 
-static struct gpio_regs* gpio_r = (struct gpio_regs*)(0x60000300);
+/* Register base (host builds in pc/host map it to memory) */
+#ifndef GPIO_REGS_ADDR
+#define GPIO_REGS_ADDR (0x60000300)
+#endif
+
+static struct gpio_regs* gpio_r = (struct gpio_regs*)(GPIO_REGS_ADDR);
@@ -1955,97 +1955,166 @@ const uint8_t __jquery_min_js[] PROGMEM = {
 };
 
 const uint8_t __index_html[] PROGMEM = {
-0x1f,0x8b,0x8,0x0,0x0,0x0,0x0,0x0,0x2,0x3,0xad,0x56,0x5d,0x6f,0xdb,0x36,
-0x14,0x7d,0xae,0x7e,0x5,0xa7,0x87,0x21,0x1,0x24,0x2b,0xf6,0xe0,0xa2,0x4b,0x25,
-0x3,0x41,0x6a,0x24,0x7d,0x70,0x62,0xc4,0xe,0x96,0xa1,0x28,0xa,0x5a,0xbc,0xb1,
-0x98,0x50,0xa4,0x4a,0x52,0x4a,0xbd,0x5f,0xbf,0x4b,0xca,0xb3,0xec,0x4c,0xcb,0x12,
-0x6c,0x4f,0x26,0xa9,0x73,0xcf,0x3d,0x97,0xbc,0x1f,0x4e,0x7f,0xfa,0x74,0x7d,0xbe,
-0xfc,0x7d,0x3e,0x25,0x85,0x2d,0xc5,0x24,0x48,0xdd,0xf,0x11,0x54,0xae,0xb3,0xb0,
-0x12,0xa1,0x3b,0x0,0xca,0x26,0xc1,0xbb,0xb4,0x4,0x4b,0x49,0x5e,0x50,0x6d,0xc0,
-0x66,0x61,0x6d,0xef,0xe3,0xf,0xe1,0xee,0x5c,0xd2,0x12,0xb2,0xb0,0xe1,0xf0,0x54,
-0x29,0x6d,0x43,0x92,0x2b,0x69,0x41,0x22,0xee,0x89,0x33,0x5b,0x64,0xc,0x1a,0x9e,
-0x43,0xec,0x37,0x11,0xe1,0x92,0x5b,0x4e,0x45,0x6c,0x72,0x2a,0x20,0x1b,0x46,0xc4,
-0x14,0x9a,0xcb,0xc7,0xd8,0xaa,0xf8,0x9e,0xdb,0x4c,0x2a,0xcf,0x6b,0xb9,0x15,0x30,
-0x99,0x2e,0xe6,0xdf,0x16,0x82,0x33,0xd0,0x69,0xd2,0x9e,0x1c,0xba,0x64,0x60,0x72,
-0xcd,0x2b,0xcb,0x95,0xdc,0xf3,0xda,0x5a,0x3c,0x97,0xf7,0x8,0x9b,0x27,0xa5,0x99,
-0xf9,0x1b,0x30,0x42,0x2f,0x1f,0x46,0xef,0xdf,0x77,0x6,0x85,0xb5,0x55,0xc,0xdf,
-0x6b,0xde,0x64,0xe1,0x5d,0x7c,0x4b,0xe3,0x73,0x55,0x56,0xd4,0xf2,0x95,0x80,0x3d,
-0xeb,0xcf,0xd3,0xc,0xd8,0x1a,0xbc,0x99,0xc0,0x8,0x88,0x6,0x91,0x85,0xc6,0x6e,
-0x4,0x98,0x2,0x0,0xef,0xa1,0xd0,0x70,0x9f,0x85,0x25,0xe5,0x72,0x90,0x1b,0xe3,
-0x81,0xad,0x5e,0x62,0x74,0x9e,0x85,0xce,0x8d,0x39,0x4d,0x12,0xfa,0x40,0x7f,0xc,
-0xd6,0x4a,0xad,0x5,0xd0,0x8a,0x9b,0x41,0xae,0x4a,0x7f,0x96,0x8,0xbe,0x32,0xc9,
-0xc3,0xf7,0x1a,0xf4,0x26,0xf9,0x65,0x30,0x1e,0xc,0xb7,0x9b,0x41,0x89,0x8c,0xf,
-0x48,0x98,0x26,0x2d,0xdf,0x73,0x66,0xef,0xf2,0x10,0x90,0x26,0xed,0x53,0xa6,0x2b,
-0xc5,0x36,0xe,0xcf,0x78,0x43,0x72,0x41,0x8d,0xc9,0xc2,0x95,0x95,0xf1,0x5a,0xab,
-0xba,0x72,0x12,0xdf,0xa5,0xab,0xda,0x5a,0x25,0x9,0x67,0xf8,0xa5,0xb6,0xdf,0x4,
-0xdc,0xdb,0x70,0xf2,0xb3,0xa0,0x5a,0x7f,0x24,0x64,0x88,0x61,0x36,0x69,0xd2,0x62,
-0xfa,0xe0,0x9a,0xaf,0xb,0x87,0xd7,0xfd,0xf8,0x34,0x41,0xc7,0x13,0xf2,0x56,0x1,
-0xe3,0x4e,0xc1,0xf8,0x55,0xa,0xc6,0x9d,0x84,0xf1,0xff,0x23,0x61,0x78,0xb2,0xd3,
-0x30,0x3c,0x79,0x95,0x6,0x6f,0xa1,0xfb,0x2d,0x5a,0x11,0x6f,0xd5,0x30,0xea,0x34,
-0x8c,0x5e,0xa7,0x61,0xd4,0x69,0x18,0xfd,0x77,0xd,0x85,0x2a,0x31,0xe1,0x2f,0xaf,
-0x67,0xd3,0x3e,0xc7,0x3e,0xf7,0x11,0x48,0xf3,0x47,0x47,0x21,0x59,0x9c,0x2b,0xa1,
-0xf4,0xa9,0x6,0xf6,0x31,0xdc,0x71,0x18,0xab,0x90,0x7c,0xb1,0xbc,0x9e,0xbf,0x45,
-0x4a,0x5a,0x69,0x70,0xd9,0x3b,0xc1,0x5a,0x2c,0xa9,0x64,0xe6,0x14,0xad,0x27,0x41,
-0x30,0x9d,0x11,0x12,0x13,0x90,0x14,0x8b,0x93,0x94,0xa,0xe9,0xb4,0x89,0x2,0x7,
-0xcc,0xb2,0x2c,0x8e,0x63,0x32,0x53,0xd,0x94,0x58,0xb0,0xd8,0x78,0x5c,0xf8,0x4a,
-0xd4,0xae,0x5d,0x18,0x12,0xc7,0x8,0xf0,0x1c,0xc8,0x80,0x14,0x74,0x65,0xdc,0x37,
-0x47,0xd2,0x80,0x3,0x23,0x99,0xd2,0x7,0x26,0x47,0xb3,0x88,0xd5,0x9a,0xba,0xd,
-0xf9,0x52,0x9a,0xaf,0x91,0xb1,0x54,0xe3,0x3d,0x43,0x13,0xe1,0x62,0xd,0x7e,0x79,
-0x1c,0x5,0xb3,0x1b,0x47,0x88,0xed,0x0,0xa1,0xcd,0xcb,0x84,0x37,0xcf,0x18,0x19,
-0x8,0x6c,0x40,0x5b,0x9a,0x4b,0x47,0xe3,0xad,0xad,0x22,0xee,0xea,0xc9,0x11,0x60,
-0xe4,0x78,0x7f,0xc4,0x3c,0x71,0x9b,0x17,0x84,0x1b,0xc4,0x62,0xa3,0xc2,0x1b,0x3e,
-0xfe,0xc7,0xa8,0x4b,0x9e,0x6b,0x65,0x2c,0x54,0xfb,0x41,0x5f,0x2c,0xfb,0x83,0xee,
-0xb0,0x47,0x17,0xcb,0xde,0x70,0x77,0x90,0xbf,0x82,0xde,0x1d,0x1c,0x23,0xeb,0x4d,
-0x6f,0xe4,0x7,0xac,0xfd,0x31,0x77,0x18,0x47,0x73,0xf9,0xb6,0xc8,0x6f,0x7d,0x16,
-0xd4,0x12,0x9b,0x33,0xe3,0x8e,0x99,0x8a,0x17,0x55,0xfc,0x76,0x76,0x73,0xf5,0xf9,
-0xea,0xe2,0x94,0x30,0x45,0xa4,0xb2,0x38,0xd9,0x20,0x7f,0x24,0x82,0x97,0xdc,0x9a,
-0x1,0x39,0xba,0x9d,0xfd,0xab,0xc4,0x60,0xb1,0x9c,0xa3,0x4b,0x97,0xc6,0xde,0xc1,
-0xc1,0xed,0xcf,0xa9,0xc6,0x99,0x63,0x41,0x1b,0x82,0xf3,0x72,0xff,0xd6,0x7f,0x3d,
-0x71,0x46,0x78,0x66,0xb,0x8c,0xa0,0x52,0xc6,0x78,0xb9,0x84,0x1a,0xf2,0x7,0x68,
-0x85,0x27,0x5c,0xda,0x28,0x38,0xf7,0x29,0xe9,0x6c,0xdb,0xa4,0xc9,0x6b,0xad,0xb7,
-0xaf,0xf9,0xa5,0x3c,0xfb,0x1a,0x5,0x8b,0xe,0xd0,0x45,0x55,0x81,0x26,0xfe,0x61,
-0xf6,0xb5,0x2c,0x96,0x67,0xcb,0xdb,0xc5,0x9e,0x86,0xbb,0x3b,0x67,0x5a,0xe1,0xd0,
-0xc5,0x69,0x61,0xa9,0xad,0xb1,0x5e,0xb0,0xfe,0x7c,0x7d,0xbd,0x5c,0x87,0xa3,0xb6,
-0x27,0x70,0x59,0xd5,0x18,0xc0,0xa6,0xc2,0x5a,0xb7,0xf0,0xc3,0xb6,0xa5,0x9d,0x97,
-0x2c,0xdc,0x8e,0x5a,0xb7,0xec,0xeb,0x1e,0x6,0xdf,0x10,0x2b,0x7f,0x7a,0xf5,0xa9,
-0xaf,0xf2,0x93,0x95,0x7e,0xe6,0x18,0x5f,0x13,0xd3,0x13,0xb6,0xfc,0xdb,0x4d,0x67,
-0x82,0x16,0x7e,0x96,0xe1,0x68,0xf3,0xff,0x5e,0xfe,0x4,0xe,0xbe,0x50,0x2e,0xce,
-0x8,0x0,0x0,};
+0x1f,0x8b,0x8,0x0,0x0,0x0,0x0,0x0,0x2,0x3,0xad,0x58,0x6b,0x6f,0xdb,0xb8,
+0x12,0xfd,0xbc,0xfe,0x15,0xbc,0x2,0xf6,0xc2,0x1,0x24,0xbf,0xda,0x14,0xdd,0xac,
+0x1d,0xa0,0x79,0xb4,0xdd,0xdd,0xa6,0x31,0x62,0x7,0xed,0xdd,0xa0,0x58,0xd0,0xd2,
+0xd8,0x66,0x43,0x89,0x5a,0x92,0x72,0x9a,0xfe,0xfa,0x7b,0x86,0x72,0xfc,0x48,0xbc,
+0x69,0x82,0x7b,0xbf,0xc4,0x22,0x35,0x73,0x78,0xe6,0xc1,0x99,0x51,0xfa,0xff,0x3a,
+0x39,0x3f,0x1e,0xff,0x67,0x78,0x2a,0xe6,0x3e,0xd7,0x87,0x8d,0x3e,0xff,0x8,0x2d,
+0x8b,0xd9,0x20,0x2a,0x75,0xc4,0x1b,0x24,0xb3,0xc3,0xc6,0x4f,0xfd,0x9c,0xbc,0x14,
+0xe9,0x5c,0x5a,0x47,0x7e,0x10,0x55,0x7e,0x9a,0xbc,0x8e,0x56,0xfb,0x85,0xcc,0x69,
+0x10,0x2d,0x14,0xdd,0x94,0xc6,0xfa,0x48,0xa4,0xa6,0xf0,0x54,0x40,0xee,0x46,0x65,
+0x7e,0x3e,0xc8,0x68,0xa1,0x52,0x4a,0xc2,0x22,0x16,0xaa,0x50,0x5e,0x49,0x9d,0xb8,
+0x54,0x6a,0x1a,0x74,0x63,0xe1,0xe6,0x56,0x15,0xd7,0x89,0x37,0xc9,0x54,0xf9,0x41,
+0x61,0x2,0xae,0x57,0x5e,0xd3,0xe1,0xe9,0x68,0xf8,0xd7,0x48,0xab,0x8c,0x6c,0xbf,
+0x5d,0xef,0x6c,0x1f,0x99,0x91,0x4b,0xad,0x2a,0xbd,0x32,0xc5,0xc6,0xa9,0xb5,0xc6,
+0x7d,0x7a,0xd7,0x74,0x7b,0x63,0x6c,0xe6,0x1e,0x8,0xc6,0x38,0xe5,0x75,0xef,0xd5,
+0xab,0xb5,0xc2,0xdc,0xfb,0x32,0xa1,0xbf,0x2b,0xb5,0x18,0x44,0x9f,0x93,0x4b,0x99,
+0x1c,0x9b,0xbc,0x94,0x5e,0x4d,0x34,0x6d,0x68,0xff,0x76,0x3a,0xa0,0x6c,0x46,0x41,
+0x4d,0xc3,0x2,0x61,0x49,0xf,0x22,0xe7,0x6f,0x35,0xb9,0x39,0x11,0xfc,0x30,0xb7,
+0x34,0x1d,0x44,0xb9,0x54,0x45,0x2b,0x75,0x2e,0x8,0xd6,0x7c,0x85,0xb3,0xe9,0x20,
+0xe2,0x63,0xdc,0x41,0xbb,0x2d,0xbf,0xca,0x6f,0xad,0x99,0x31,0x33,0x4d,0xb2,0x54,
+0xae,0x95,0x9a,0x3c,0xec,0xb5,0xb5,0x9a,0xb8,0xf6,0xd7,0xbf,0x2b,0xb2,0xb7,0xed,
+0x17,0xad,0xfd,0x56,0x77,0xb9,0x68,0xe5,0x40,0xfc,0xa,0xc0,0x7e,0xbb,0xc6,0xbb,
+0x8f,0x1c,0x8e,0xdc,0x16,0xe8,0xb7,0xeb,0x50,0xf6,0x27,0x26,0xbb,0x65,0xf9,0x4c,
+0x2d,0x44,0xaa,0xa5,0x73,0x83,0x68,0xe2,0x8b,0x64,0x66,0x4d,0x55,0x32,0xc5,0x9f,
+0xfa,0x93,0xca,0x7b,0x53,0x8,0x95,0xe1,0x4d,0xe5,0xff,0xd2,0x34,0xf5,0xd1,0xe1,
+0xbf,0xb5,0xb4,0xf6,0x57,0x21,0xba,0x30,0x73,0xd1,0x6f,0xd7,0x32,0xbb,0xc4,0xad,
+0x9a,0xcd,0x59,0xde,0xee,0x96,0xef,0xb7,0x71,0xf0,0xa1,0x78,0x2e,0x81,0xfd,0x35,
+0x83,0xfd,0x27,0x31,0xd8,0x5f,0x53,0xd8,0xff,0xff,0x50,0xe8,0x76,0x56,0x1c,0xba,
+0x9d,0x27,0x71,0x8,0x1a,0x76,0xb7,0x46,0x4d,0xe2,0xb9,0x1c,0x7a,0x6b,0xe,0xbd,
+0xa7,0x71,0xe8,0xad,0x39,0xf4,0xfe,0x77,0xe,0x5f,0xcd,0x6c,0x3b,0x1f,0x7e,0x3f,
+0x7f,0xf7,0x18,0x5,0x96,0xdf,0x4e,0x88,0x6d,0x85,0x27,0x30,0xd0,0x72,0x42,0x5a,
+0x4c,0x8d,0x1d,0x44,0x8c,0xe6,0x4a,0xa2,0x2c,0x3a,0x4,0x8c,0x8,0x8f,0xe2,0xa,
+0x36,0xb5,0x71,0x21,0xbe,0x1c,0xf4,0xdb,0x41,0x36,0x68,0xa9,0xa2,0xac,0xbc,0xf0,
+0xb7,0x25,0x6e,0xbe,0x45,0x3d,0xc3,0xc5,0x65,0x4e,0x6b,0x84,0x65,0x55,0xd8,0xd8,
+0x0,0xc6,0x20,0xea,0xe2,0x57,0x7e,0x1b,0x44,0xaf,0x3a,0x9d,0x48,0x2c,0xa4,0xae,
+0x20,0xd3,0x65,0x1f,0x3e,0x97,0xab,0x59,0x90,0xb5,0x28,0x2f,0xd1,0xe1,0x28,0xd0,
+0xbc,0x5b,0x8b,0xab,0x9f,0x9f,0xc4,0x74,0xa5,0xbf,0x24,0xba,0x5e,0xd7,0x3c,0x3b,
+0x4b,0xa2,0xfb,0x9b,0x44,0x3b,0x4f,0x25,0x7a,0x2f,0x4c,0x73,0x93,0x83,0xe8,0xfb,
+0xf3,0xb3,0xd3,0xc7,0x82,0x59,0xca,0xca,0x41,0x6c,0xf8,0xe6,0x72,0xf4,0xa8,0x9c,
+0x25,0x57,0x31,0xde,0xc5,0xe9,0xe8,0x72,0xb,0xf1,0xf9,0xc4,0x9c,0x99,0xe2,0x8f,
+0x37,0x78,0x3b,0x3a,0x7f,0x3b,0x16,0xa3,0xf1,0xf9,0x70,0xd7,0xd1,0xa1,0xea,0x42,
+0x45,0xa6,0xd7,0xc,0x56,0x64,0x49,0x6a,0xb4,0xb1,0x7,0x96,0xb2,0x5f,0xa3,0x35,
+0x5a,0xd,0xb4,0x8d,0xf1,0x43,0x52,0xfd,0xd2,0x12,0xd7,0xcd,0x43,0x74,0x81,0x5c,
+0x16,0x99,0x43,0xf8,0x26,0x87,0x8d,0xc6,0xe9,0x99,0x10,0x89,0xa0,0x42,0xa2,0x2d,
+0x88,0xdc,0x0,0xce,0xba,0xb8,0xc1,0x82,0x83,0xc1,0x20,0x49,0x12,0x71,0x86,0x98,
+0xe5,0x68,0x15,0x68,0x79,0x7c,0xf1,0x8c,0xae,0xb8,0x51,0x39,0x91,0x24,0x10,0x8,
+0x18,0x40,0x0,0x84,0x9c,0x38,0x7e,0xc7,0x20,0xb,0x62,0x61,0x80,0x19,0xbb,0xa5,
+0xd2,0x3c,0x8b,0xb3,0xca,0x4a,0x5e,0x88,0xab,0xdc,0x7d,0x89,0x9d,0x97,0x96,0x3d,
+0xbd,0x88,0xf1,0x30,0xa3,0xf0,0xb8,0x17,0x37,0xce,0x2e,0x18,0x10,0x8d,0x8,0xa2,
+0x8b,0xc7,0x1,0x2f,0xee,0x21,0x66,0xa4,0xd1,0xfa,0x96,0x30,0xef,0x19,0x26,0x68,
+0x7b,0x23,0x38,0x3b,0x44,0x93,0x60,0x39,0xfc,0x27,0xdc,0x8d,0xf2,0xe9,0x5c,0x28,
+0x7,0x59,0xb4,0x48,0x78,0x78,0xef,0x1f,0xad,0xce,0x55,0x6a,0x8d,0xf3,0x54,0x6e,
+0x1a,0xfd,0x6e,0xbc,0xdb,0xe8,0xb5,0x6c,0xf3,0xdd,0x78,0xa7,0xb9,0x2b,0x91,0x3b,
+0xa3,0x57,0x1b,0x7b,0x40,0xbd,0xd8,0x69,0xf9,0x16,0xea,0x6e,0x9b,0xd7,0x32,0xc,
+0xf3,0xfe,0x79,0x96,0x5f,0x86,0x2c,0xa8,0xa,0x8c,0x5,0x99,0x62,0x64,0xa9,0x1f,
+0x65,0xf1,0xe9,0xcd,0xc5,0xc7,0xdf,0x3e,0xbe,0x3b,0x10,0x99,0x11,0x85,0xf1,0x98,
+0xa9,0x28,0xbd,0x16,0x5a,0xe5,0xca,0xbb,0x96,0x68,0x5e,0x9e,0xfd,0x90,0xe2,0xd1,
+0x9f,0x5b,0x31,0x26,0xe9,0x50,0x5e,0x76,0xd9,0x7b,0xf4,0xe7,0xf,0xb0,0xe2,0xb4,
+0xb2,0xb,0xda,0x8b,0x45,0xf8,0x3d,0x10,0x1d,0xe0,0x62,0x92,0x21,0x69,0x63,0xf4,
+0xed,0x24,0x40,0x3,0x34,0x31,0x28,0x50,0xcd,0x8c,0xa6,0xb2,0xd2,0x1e,0xd2,0xbd,
+0xf5,0xab,0x58,0xbc,0xb8,0x5b,0x40,0x28,0x16,0x2f,0xb1,0x4a,0x2b,0x78,0x2b,0x8f,
+0xc1,0xf3,0x18,0x2b,0xcc,0x8b,0xcb,0x9d,0xfa,0x14,0xd1,0x4c,0xab,0x89,0x4a,0xc5,
+0x11,0x7d,0x57,0x64,0x99,0xb2,0x57,0x39,0xed,0x85,0xb1,0xca,0x1a,0x2d,0x4a,0xa3,
+0xa,0x1f,0xc8,0x1f,0xc7,0x65,0x37,0x2e,0x7b,0x7b,0x2c,0x73,0xd5,0x6d,0xa3,0xb8,
+0x75,0xbe,0x88,0x66,0xa7,0xd5,0xe2,0xa7,0xbd,0xc6,0xe8,0xec,0xec,0x7,0x69,0x84,
+0x70,0xcd,0x97,0x4d,0x62,0x6a,0x71,0xbe,0x9f,0x13,0xe0,0x5d,0x88,0x52,0xa2,0x8a,
+0x8c,0xbe,0xe1,0x4d,0xfd,0x3e,0x97,0xa5,0x68,0x2,0xf1,0x61,0x62,0xc5,0x38,0xe8,
+0xf,0x3e,0x28,0xdb,0x94,0xbd,0xe6,0xd0,0x41,0xe1,0x8f,0xf8,0xe,0x10,0x1e,0x5e,
+0x9d,0x8c,0x7c,0xdd,0x6e,0x4d,0x70,0x5a,0x55,0x72,0x42,0xbd,0xe,0x9a,0x2e,0x5e,
+0x42,0x21,0x95,0x60,0x2d,0xd9,0xd2,0x20,0x98,0x58,0x4f,0xc8,0xdf,0x10,0x15,0x4b,
+0x21,0x9c,0xcc,0x1e,0x4c,0x31,0x16,0xda,0xf5,0xd9,0x71,0xe3,0xe4,0x13,0x27,0x40,
+0x76,0x43,0x5a,0xc7,0x2,0x23,0x79,0x76,0x23,0x2d,0x5,0x37,0x66,0x22,0xd4,0xe8,
+0x15,0xe,0x3b,0x5,0xbe,0x3c,0xf9,0xb4,0x9d,0x8,0x30,0xea,0xc3,0x11,0x63,0x68,
+0x83,0xb4,0x9e,0xd0,0xc,0x7e,0x6b,0x7e,0x38,0x8a,0x53,0x54,0x4e,0xe,0x70,0xf8,
+0xd,0xd9,0x60,0xa9,0x24,0xe9,0xb9,0xa3,0x11,0xfa,0x4f,0x1c,0x14,0x9c,0x48,0x65,
+0x1,0x2d,0x51,0x90,0x63,0xd2,0xcd,0xda,0xb4,0x97,0x42,0x43,0x46,0x3b,0x6,0x3f,
+0x5d,0x81,0xe3,0xee,0xc4,0xc1,0xf1,0x61,0x15,0xae,0x31,0x2,0x33,0x7,0x37,0xde,
+0xbc,0x99,0x1b,0xd4,0x4e,0x9e,0x48,0xd9,0x15,0x98,0x6d,0x2b,0xc6,0xb,0xeb,0x1c,
+0x39,0x23,0xf0,0x41,0xc0,0xe,0x32,0x41,0xf8,0xd5,0x4b,0xa0,0x79,0x7b,0xcb,0xd5,
+0x8c,0x2d,0x9,0xe2,0x60,0x8b,0x23,0x30,0x71,0xbb,0xfa,0x84,0xa0,0x66,0xc9,0x57,
+0xb6,0x10,0x4b,0xbd,0x70,0xe8,0x2a,0xf0,0x8d,0xc6,0x68,0x3c,0x4,0x3b,0xee,0x2,
+0xcb,0xa4,0xc9,0xe1,0x38,0x5,0xff,0xeb,0x5b,0xdc,0xf5,0x9c,0x90,0x0,0x45,0x7a,
+0x2b,0xf8,0xca,0x73,0xf4,0x47,0x63,0xce,0x62,0xf4,0xa1,0xa0,0x12,0x8b,0xa9,0xae,
+0xdc,0xbc,0x3e,0x5c,0xa0,0x1b,0x88,0x8c,0x52,0xd2,0x4,0xef,0x86,0x8a,0x81,0xc3,
+0xb8,0x5a,0x28,0xad,0x85,0xd4,0xa6,0x98,0x5,0x6,0x56,0xe6,0x8,0x1b,0xfa,0x26,
+0x90,0x42,0x80,0xe2,0x7b,0x5a,0x73,0xa9,0x7d,0x0,0xbb,0x26,0x2a,0x6b,0x15,0xf8,
+0x56,0x98,0x69,0x9d,0xb3,0xd6,0xcc,0x0,0x11,0x37,0xd0,0x50,0x43,0x4c,0xb8,0xbd,
+0xd6,0x40,0xd9,0xfa,0x25,0x4f,0x44,0x89,0x40,0x4,0x4c,0xaa,0x3c,0x3b,0x9,0xb3,
+0x46,0x13,0x9b,0xf7,0x73,0x31,0xe6,0x44,0xe1,0x1b,0x5d,0x67,0xc2,0x5d,0x88,0x27,
+0xc4,0x41,0x16,0x77,0x2f,0x41,0x2a,0x70,0x81,0x87,0x54,0x31,0x8b,0x79,0x6c,0x8b,
+0x39,0x21,0xd8,0x2b,0x5b,0xe5,0x7e,0x28,0x71,0x3a,0x21,0x87,0x5d,0xb8,0xea,0x1b,
+0x65,0xfe,0x17,0x96,0x1f,0x61,0xcf,0xcf,0x11,0x5c,0xf8,0x7f,0x79,0x51,0xa4,0x13,
+0xdf,0xc9,0x9a,0xfa,0xa6,0xc7,0x8d,0xe3,0xd0,0x3,0x59,0xb7,0xee,0x52,0xa8,0x12,
+0x76,0xd9,0x3e,0xae,0xf2,0x37,0x5f,0x10,0x81,0xb5,0xc0,0xfa,0x6e,0x97,0xa8,0x1d,
+0xa1,0x13,0x34,0xde,0x9e,0xf3,0xeb,0x29,0x6c,0x4c,0x82,0x3b,0x57,0x83,0x16,0x3,
+0xfc,0x8c,0x8a,0xd1,0x45,0xc9,0xc0,0x94,0xb4,0x27,0x64,0x59,0x6a,0x5,0x57,0x68,
+0x55,0x57,0xf7,0xe0,0xe7,0xaa,0x28,0x60,0x60,0x70,0xfe,0x32,0xff,0xc2,0xa5,0xd9,
+0xb2,0x71,0x4,0x5e,0x6b,0x57,0xe3,0x42,0x7d,0x50,0x1e,0x1f,0xa3,0x6f,0x47,0x7b,
+0x1b,0xf6,0xe,0xeb,0xd6,0x5b,0xf1,0x30,0xb2,0x29,0x2e,0x9a,0xc3,0x8b,0x78,0xf9,
+0xc,0x77,0xdf,0xed,0x76,0x38,0xe3,0x43,0x6a,0x42,0x54,0x56,0xa8,0x8f,0xb8,0x9f,
+0xf8,0x24,0x46,0x12,0xca,0x29,0xdc,0x9,0xf7,0xdc,0x90,0x4d,0x4c,0x81,0xc4,0x19,
+0x89,0xa5,0xe7,0x1f,0x40,0x6f,0x52,0x16,0x5c,0x5,0xb8,0x2e,0xc9,0xe9,0x94,0x52,
+0x1f,0xba,0xd3,0xf0,0x24,0x94,0xa,0xa4,0x9a,0xa7,0x87,0xbc,0x4e,0xd6,0xbc,0x1a,
+0xc3,0xf,0xe1,0xce,0x2a,0xa4,0x9d,0xbb,0x6f,0x2e,0x4f,0xa0,0xb1,0x53,0xdf,0x29,
+0x4e,0x6d,0xfa,0xa2,0xb7,0xdd,0xef,0x47,0xe3,0x37,0xe3,0xcb,0xd1,0x86,0x23,0x3e,
+0x7f,0x66,0xa4,0x12,0x1f,0xf5,0xc,0x25,0x7d,0x5,0x67,0x62,0xca,0xa,0x53,0xd4,
+0xe3,0xd3,0x56,0x2f,0x7a,0x30,0x11,0x7b,0xfa,0xe6,0xeb,0x1,0x2e,0xcd,0x57,0x43,
+0x3b,0x3f,0xee,0x9c,0x16,0x51,0xa,0x30,0xdf,0x9d,0x7e,0x3c,0xd9,0x35,0xdf,0xb5,
+0x27,0xf6,0xde,0xc1,0xe8,0x39,0xe8,0x1e,0xcb,0x81,0xfb,0x6e,0xb1,0x56,0x81,0x46,
+0xf8,0x56,0xc6,0xa7,0x73,0xf8,0xef,0xc8,0x7f,0x1,0x42,0xc4,0xa0,0x2d,0x2e,0x11,
+0x0,0x0,};
 
 const uint8_t __main_js[] PROGMEM = {
-0x1f,0x8b,0x8,0x0,0x0,0x0,0x0,0x0,0x2,0x3,0x95,0x54,0x5d,0x8f,0xda,0x30,
-0x10,0x7c,0x4e,0x7e,0x85,0xeb,0x22,0xc5,0xd1,0x71,0x21,0x70,0xa2,0xf,0x69,0xe9,
-0xb,0x3a,0xa9,0x52,0x7b,0x5,0x15,0xde,0x4e,0x55,0xe5,0x73,0x96,0x8f,0x36,0x89,
-0x91,0xed,0xd0,0x9e,0x50,0xfe,0x7b,0x37,0x4e,0x82,0x72,0x10,0x9,0x78,0x40,0x8a,
-0xbd,0x33,0xb3,0x33,0xeb,0x15,0xee,0x2a,0xcf,0x84,0xd9,0xca,0x8c,0xf0,0x38,0x7e,
-0x2,0xad,0xf9,0x1a,0x58,0xea,0xbb,0x7,0xd7,0x11,0x32,0xd3,0x32,0x81,0x20,0x91,
-0x6b,0xbc,0xf9,0xe8,0x3a,0x3d,0x46,0xdf,0xd7,0x97,0xd4,0xf,0xf8,0x6e,0x7,0x59,
-0xcc,0xd2,0x3b,0xfa,0x69,0xf0,0xa2,0x3e,0x53,0x44,0x14,0xae,0x7b,0x94,0xd3,0x58,
-0x9c,0xca,0x34,0xe5,0x88,0x11,0x56,0xaf,0x17,0xf0,0xdf,0xfc,0x1f,0xc3,0x2f,0x27,
-0x57,0x49,0x44,0x77,0x52,0x1b,0xda,0xc7,0x93,0x79,0xdd,0x41,0x44,0xe7,0xb3,0xc5,
-0xd2,0x1e,0x63,0x6e,0x78,0x74,0x10,0x69,0x1c,0x11,0x51,0x34,0x17,0x4b,0x8b,0xd9,
-0x98,0x34,0xb1,0x18,0x9d,0xb,0x81,0x66,0xa3,0xa6,0x1d,0x2b,0x31,0x3e,0x29,0xb5,
-0x9d,0x56,0x10,0x6f,0x5a,0xaa,0x78,0xe4,0x8e,0xd8,0x3a,0x66,0x70,0xa,0xd7,0x29,
-0x4e,0xad,0x1a,0xae,0xcc,0xe3,0x1e,0x32,0xa3,0x99,0x4f,0x4a,0xab,0x7b,0xae,0x8,
-0x68,0x32,0x21,0x19,0xfc,0x25,0xb6,0xb2,0x90,0xb9,0x12,0x28,0x38,0x0,0x8b,0xf3,
-0x4a,0x2d,0xd0,0x81,0xcc,0x24,0x4e,0x1,0x81,0x47,0x23,0x50,0xb9,0x68,0x99,0xa0,
-0x95,0x34,0x99,0x21,0x12,0xe2,0x72,0x4e,0x4e,0xd1,0xb0,0x41,0x29,0xa9,0x3a,0xe8,
-0xdb,0x15,0x61,0x10,0xa0,0xaf,0x35,0x98,0x40,0x1,0x8f,0x5f,0x17,0x86,0x1b,0x20,
-0xef,0x26,0x6d,0x3b,0xc1,0x6c,0xfe,0xf8,0xfd,0x3c,0x75,0xd3,0x70,0x9a,0x48,0x5d,
-0x37,0xb4,0xb1,0x9b,0xa6,0x69,0x85,0xbb,0xc6,0x75,0x44,0x28,0xe,0xf,0x82,0x66,
-0x7c,0xb5,0x6,0xe2,0x6c,0xf9,0xdb,0x56,0x1b,0xc,0xa5,0x98,0x87,0xcf,0xe5,0xf5,
-0x2f,0xeb,0x3d,0x23,0xee,0xe7,0xa9,0x68,0x9d,0xb6,0x3c,0x92,0xc9,0x84,0xd0,0xd9,
-0x57,0x5a,0x87,0x1a,0xc,0xda,0x6b,0x74,0xc,0x82,0x8d,0x78,0xa2,0xa1,0x7a,0xc6,
-0x1e,0x8b,0xa5,0xc8,0x53,0x14,0xf7,0xab,0x49,0xb1,0xa3,0xb,0xbb,0x76,0x6f,0x5e,
-0xb7,0xde,0xe2,0x97,0xdc,0xfc,0x4a,0x60,0x65,0x70,0x8d,0x45,0xb2,0x15,0x7f,0x5a,
-0x94,0xc3,0x9b,0xcd,0xa5,0x4f,0x3f,0xfa,0xc3,0x30,0xc,0xfb,0xf7,0x43,0x9c,0x63,
-0xd1,0xe6,0xab,0xed,0x7a,0x73,0x83,0xc0,0x19,0xbf,0xec,0x3f,0xbe,0x8a,0xff,0x60,
-0xd,0x8c,0x3b,0xd,0xdc,0xa0,0x30,0xee,0x72,0x30,0xc,0xaf,0x12,0xf8,0x50,0xcd,
-0x20,0xec,0xf4,0x30,0xba,0x4e,0x63,0x38,0x2a,0x45,0x46,0x61,0x97,0x8d,0x9b,0x24,
-0xee,0x47,0xdd,0x3e,0x6e,0xc9,0x72,0x1e,0x45,0x1b,0xb9,0xbb,0xcc,0x5f,0x2c,0xe7,
-0xa7,0xc4,0x8d,0x4c,0xe1,0x8a,0xc6,0x5f,0xce,0x1a,0x62,0xf9,0x22,0xcf,0xfe,0xe7,
-0xa6,0x25,0x6e,0xcf,0x13,0xe6,0x57,0x12,0xf8,0xfb,0xf,0x16,0xfc,0xf,0x8d,0xb8,
-0x5,0x0,0x0,};
+0x1f,0x8b,0x8,0x0,0x0,0x0,0x0,0x0,0x2,0x3,0x95,0x56,0xdb,0x6e,0xda,0x40,
+0x10,0x7d,0xb6,0xbf,0x62,0xbb,0x45,0xc2,0x6e,0x88,0x31,0x54,0xf4,0x81,0x94,0x4a,
+0x55,0x94,0xa6,0xb7,0x14,0x14,0xe8,0x53,0x55,0x45,0x1b,0x7b,0x0,0xa7,0xb6,0xd7,
+0xf2,0xae,0x49,0xa3,0x88,0x7f,0xef,0xec,0xfa,0x52,0x63,0x1c,0x1,0xf,0x28,0xd8,
+0x33,0xe7,0xcc,0x99,0x33,0xb3,0x4b,0xcc,0x65,0x16,0x7b,0x32,0xe0,0x31,0x61,0xbe,
+0x7f,0x3,0x42,0xb0,0x15,0x58,0x91,0x6d,0x3e,0x9b,0x86,0xc7,0x63,0xc1,0x43,0x70,
+0x42,0xbe,0xc2,0x37,0x17,0xa6,0xd1,0xb1,0xe8,0xeb,0xe2,0x25,0xb5,0x1d,0x96,0x24,
+0x10,0xfb,0x56,0x74,0x46,0xdf,0xf7,0xef,0xd3,0xf,0x14,0x33,0xb6,0xa6,0x59,0xd1,
+0x9,0xc,0x5e,0xf2,0x28,0x62,0x98,0xe3,0x69,0xbe,0x8e,0xc3,0x1e,0xd8,0x5f,0xb,
+0xbf,0x19,0x59,0x1a,0x8e,0x69,0xc2,0x85,0xa4,0x3d,0x7c,0x92,0x4f,0x9,0x8c,0xe9,
+0x6c,0x3a,0x5f,0xe8,0x47,0x9f,0x49,0x36,0x7e,0xf6,0x22,0x7f,0x4c,0xbc,0x6d,0xf9,
+0x62,0xa1,0x73,0xd6,0x32,0xa,0x75,0x8e,0xc8,0x3c,0xf,0xc5,0x8e,0xcb,0x72,0x96,
+0xca,0xb1,0x89,0xe2,0x36,0x6a,0x8d,0x74,0x2f,0x15,0x4b,0x97,0x9c,0x11,0x1d,0xc7,
+0x1e,0x8c,0xad,0x69,0x6c,0x9b,0x52,0x25,0x4b,0xe5,0xd5,0x6,0x62,0x29,0x2c,0x9b,
+0x28,0xa9,0x1b,0x96,0x12,0x10,0x64,0x42,0x62,0x78,0x24,0x3a,0x32,0xe7,0x59,0xea,
+0x21,0x61,0x1f,0x74,0x5e,0x57,0x71,0x81,0x70,0x78,0xcc,0xd1,0x5,0x4c,0xac,0x84,
+0x40,0xae,0xa2,0x26,0x82,0xe6,0xd4,0x64,0x8a,0x99,0xe0,0x2b,0x9f,0x8c,0x6d,0x89,
+0x86,0x34,0xe5,0x69,0xb,0x3c,0x58,0x12,0xb,0x1c,0xd4,0xb5,0x2,0xe9,0xa4,0xc0,
+0xfc,0xa7,0xb9,0x64,0x12,0xc8,0xab,0x49,0x5d,0x8e,0x33,0x9d,0x5d,0xfd,0xd8,0xef,
+0xba,0x2c,0x78,0x19,0x72,0x51,0x14,0xd4,0x6d,0x97,0x45,0xa3,0x3c,0xef,0x18,0xd5,
+0x63,0x42,0xd1,0x3c,0x70,0x4a,0xfb,0xa,0xe,0xcc,0xd3,0xe1,0xef,0x81,0x90,0xd8,
+0x54,0x6a,0x75,0x71,0x5c,0xdd,0xde,0x61,0xbe,0x5f,0x98,0xf7,0xbb,0x49,0x5a,0x74,
+0xab,0x1e,0xc9,0x64,0x42,0xe8,0xf4,0x1b,0x2d,0x9a,0xea,0xf7,0xeb,0x6b,0x54,0x35,
+0x82,0x85,0x58,0x28,0x20,0x1f,0xa3,0x9a,0xd5,0x3,0x5f,0x2d,0x82,0x8,0x94,0x93,
+0x71,0x16,0x86,0x17,0xb5,0xe1,0x62,0x68,0xae,0xe6,0x6b,0xf9,0x41,0x6a,0x97,0xb3,
+0x45,0x15,0x98,0x4a,0xbf,0x4e,0xaf,0x7b,0x4a,0x8a,0x8a,0x91,0x37,0x44,0xed,0x37,
+0xa6,0xdf,0x89,0x4,0x94,0x6d,0xce,0x86,0x85,0x96,0x6d,0x63,0x9c,0xf6,0x46,0xae,
+0x4b,0xb1,0xba,0x26,0xe3,0x89,0x56,0xb2,0xb3,0xe0,0x91,0x6f,0xe7,0xe1,0x52,0x86,
+0x0,0xf9,0x25,0x96,0x90,0x2a,0x8e,0xca,0x15,0xec,0x8a,0xec,0xc1,0x8,0xb6,0x33,
+0x74,0xdd,0xc6,0x4e,0x56,0x95,0x94,0x64,0xe5,0x4f,0xc9,0x9d,0x3b,0xe3,0x85,0xc0,
+0xd2,0xaa,0x40,0x15,0x53,0x6,0xed,0x79,0x61,0xec,0x48,0xd5,0x4d,0xbb,0xf9,0x16,
+0xaa,0x8a,0x1d,0xcb,0xe7,0x5e,0x16,0xe1,0x6c,0xec,0x7c,0xd1,0x6a,0x72,0x55,0xed,
+0x9d,0xc3,0x51,0x5c,0x2,0xf7,0x99,0xbc,0xb,0x61,0x29,0xd1,0x23,0x2f,0xc,0xbc,
+0x3f,0x35,0xc8,0x6e,0x83,0xf4,0xe6,0xb6,0x37,0x70,0x5d,0xb7,0x77,0x3e,0xc0,0x8a,
+0xdb,0x3a,0x3e,0xd,0x56,0xeb,0x13,0x8,0xf6,0xf0,0xaa,0xfe,0xe8,0x28,0xfc,0x5b,
+0x2d,0x60,0xd4,0x2a,0xe0,0x4,0x86,0x51,0x9b,0x82,0x81,0x7b,0x14,0xc1,0xbb,0xdc,
+0x3,0xb7,0x55,0xc3,0xf0,0x38,0x8e,0xc1,0x50,0x91,0xc,0xdd,0x36,0x19,0x27,0x51,
+0x9c,0xf,0xdb,0x75,0x9c,0xd2,0xcb,0x7e,0x2b,0xea,0xe0,0x14,0x3b,0x81,0x38,0x1a,
+0xf1,0xc,0xef,0x1e,0xfe,0x18,0x13,0xc9,0x33,0x6f,0xad,0xb7,0x88,0xd6,0x2e,0x8,
+0x24,0xae,0x4e,0xe6,0xf9,0xa0,0x85,0xab,0xdc,0x8f,0x53,0xc9,0x6,0x2f,0xe8,0xea,
+0x91,0x97,0xa9,0xb3,0x84,0xe8,0xbf,0x78,0xa8,0x36,0x90,0xd7,0xc0,0xa6,0xdb,0x2a,
+0xe8,0xb3,0xbf,0xc3,0x2f,0xf0,0xdd,0x61,0xdf,0xe6,0x8b,0x59,0xd3,0x30,0xc1,0x97,
+0x47,0xa3,0xf1,0x97,0xb1,0x81,0x4e,0x18,0xea,0x3d,0x8c,0x9c,0x7d,0xfc,0xb9,0x37,
+0x6b,0x10,0x78,0xdc,0xf,0x43,0x6f,0xaf,0xe6,0x4d,0xe8,0x9a,0x1f,0x3,0xbc,0xf9,
+0x5c,0xc7,0xf1,0xd,0xfe,0xc6,0x5,0x3e,0x14,0x7e,0x7b,0x6b,0x16,0xaf,0xa0,0x61,
+0xed,0xe,0xfc,0xd3,0x54,0xdf,0xc9,0x1d,0x4b,0xae,0x3,0x51,0x5e,0xc2,0xd,0xeb,
+0xd4,0x74,0xe,0xe9,0xd0,0xff,0xad,0x44,0xff,0xef,0x71,0x4d,0x81,0x9f,0x7f,0xf9,
+0xf4,0xa0,0x25,0xf2,0x8,0x0,0x0,};
 
 const uint8_t __bulma_min_css[] PROGMEM = {
 0x1f,0x8b,0x8,0x0,0x0,0x0,0x0,0x0,0x2,0x3,0xd5,0xbd,0xfb,0x6f,0xf3,0xca,
@@ -3747,8 +3816,8 @@ const uint8_t __bulma_min_css[] PROGMEM = {
 };
 
 #define www_bulma_min_css_size 27136
-#define www_index_html_size 883
+#define www_index_html_size 1746
 #define www_jquery_min_js_size 30752
 #define www_main_css_size 451
-#define www_main_js_size 515
+#define www_main_js_size 759
 
@@ -0,0 +1,184 @@
+/*
+ * Fixed-point motion planner - shared by the firmware and host tools (no Arduino dependencies).
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include "Planner.h"
+
+uint32_t planner_min_period = MIN_PERIOD;
+
+const int planner_curve_p[CURVE_CUSTOM][2] = {
+	{333, 667},                        /* Linear      */
+	{0, 1000},                         /* Ease in-out */
+	{0, 333},                          /* Ease in     */
+	{667, 1000},                       /* Ease out    */
+};
+
+/*!
+ * \brief Convert period (in clock cycles) to the half period supported by hardware.
+ */
+uint32_t planner_hperiod(uint64_t period)
+{
+	if (period < planner_min_period) period = planner_min_period;
+#ifdef USE_RAMP
+	if (period < RMAXIMUM_PERIOD) period = RMAXIMUM_PERIOD;
+#endif
+	return ((period >> 1)&0xffffffff);
+}
+//====================================================================================
+
+/*!
+ * \brief Duration solver - STEP period (not limited) for move of xSteps in duration [ms].
+ */
+uint64_t planner_duration_period(int duration, int xSteps)
+{
+	int aX = xSteps;
+
+	if (duration == 0) duration = 100;
+	/* ABS */
+	if (aX < 0) aX = -aX;
+	if (aX) return (((uint64_t)duration * 80000)/aX)-1;
+	return 160000;
+}
+//====================================================================================
+
+/*!
+ * \brief Duration solver - cruise half period for move of xSteps in duration [ms].
+ */
+uint32_t planner_duration_hperiod(int duration, int xSteps)
+{
+	return planner_hperiod(planner_duration_period(duration, xSteps));
+}
+//====================================================================================
+
+/*!
+ * \brief Half period for speed in [microsteps/s] (sign is ignored, speed != 0).
+ */
+uint32_t planner_speed_hperiod(int speed)
+{
+	if (speed < 0) speed = -speed;
+	return planner_hperiod(PLANNER_CLOCK / speed);
+}
+//====================================================================================
+
+/*!
+ * \brief Apply feed-rate override in [%] to the half period.
+ */
+uint32_t planner_override(uint32_t hperiod, int percent)
+{
+	return planner_hperiod(((uint64_t)hperiod * 200) / percent);
+}
+//====================================================================================
+
+/*!
+ * \brief Move duration in [ms] for xSteps at speed in [microsteps/s].
+ */
+int planner_speed_duration(int xSteps, int speed)
+{
+	if (xSteps < 0) xSteps = -xSteps;
+	return (int)(((int64_t)xSteps * 1000) / speed);
+}
+//====================================================================================
+
+/*!
+ * \brief Limit position to <0, max>.
+ */
+int planner_clamp(int pos, int max)
+{
+	if (pos > max) pos = max;
+	if (pos < 0) pos = 0;
+	return pos;
+}
+//====================================================================================
+
+/*!
+ * \brief Braking distance (in steps) from the given half period to start/stop speed.
+ */
+int planner_brake_steps(uint32_t hperiod)
+{
+	int b = 0;
+
+#ifdef USE_RAMP
+	for (uint32_t l = hperiod; l < RSTART_STOP_HPERIOD; l++) b += ramp[RSTART_STOP_HPERIOD - 1 - l] + 1;
+#endif
+	return b;
+}
+//====================================================================================
+
+/*!
+ * \brief Predicted move time in clock cycles (ramp included, no feed-rate override).
+ * Runs the same ramp step as the ISR, so the result matches the hardware step for step.
+ */
+uint64_t planner_move_cycles(int xSteps, uint32_t hperiod)
+{
+	uint64_t t = 0;
+	uint32_t h = hperiod;
+	int      n = (xSteps < 0) ? -xSteps : xSteps;
+#ifdef USE_RAMP
+	int      iter = 0, brake = 0;
+
+	if (h < RSTART_STOP_HPERIOD) h = RSTART_STOP_HPERIOD;
+#endif
+	/* STEP high + STEP low, speed is updated after every falling edge */
+	for (int i = 0; i < n; ++i) {
+		t += (uint64_t)h << 1;
+#ifdef USE_RAMP
+		planner_ramp_step(&h, hperiod, &iter, &brake, n - i - 1);
+#endif
+	}
+	return t;
+}
+//====================================================================================
+
+/*!
+ * \brief Curve position (Q16) - 1D cubic Bezier 0, p1, p2, 1 at time s (Q16).
+ */
+int64_t planner_curve(int64_t s, int64_t p1, int64_t p2)
+{
+	int64_t u  = 65536 - s;
+	int64_t b1 = (3 * u * u * s) >> 32;
+	int64_t b2 = (3 * u * s * s) >> 32;
+	int64_t b3 = (s * s * s) >> 32;
+	return ((b1 * p1 + b2 * p2) >> 16) + b3;
+}
+//====================================================================================
+
+/*!
+ * \brief Convert curve control ordinate from [1/1000] to Q16.
+ */
+int planner_curve_ordinate(int p)
+{
+	return (p << 16) / 1000;
+}
+//====================================================================================
+
+/*!
+ * \brief Automatic microstep resolution for a move.
+ * Slow moves use the finest resolution that still runs without ramp (below start/stop speed),
+ * rapids use the coarsest resolution needed to reach the speed, other moves the user resolution.
+ * \param fperiod - period in clock cycles per 1/256 microstep (Q8),
+ * \param ushift  - user resolution (1/256 microsteps per STEP = 1 << ushift),
+ * \param smax    - coarsest allowed resolution.
+ * \return resolution (1/256 microsteps per STEP = 1 << shift).
+ */
+int planner_auto_shift(uint64_t fperiod, int ushift, int smax)
+{
+	uint64_t limit = planner_min_period;
+	int      s;
+
+#ifdef USE_RAMP
+	if (limit < RMAXIMUM_PERIOD) limit = RMAXIMUM_PERIOD;
+	for (s = 0; s < ushift; ++s) {
+		if (((fperiod << s) >> 8) >= (2 * RSTART_STOP_HPERIOD)) return s;
+	}
+#endif
+	for (s = ushift; s < smax; ++s) {
+		if (((fperiod << s) >> 8) >= limit) break;
+	}
+	return s;
+}
+//====================================================================================
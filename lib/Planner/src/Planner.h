@@ -0,0 +1,103 @@
+/*
+ * Fixed-point motion planner - shared by the firmware and host tools (no Arduino dependencies).
+ * All periods are in timer1 clock cycles (80MHz), positions in microsteps.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __PLANNER_H__
+#define __PLANNER_H__
+
+#include <stdint.h>
+#include "ramp.h"
+
+#define PLANNER_CLOCK     (80000000u)         /*!< Step generator clock in [Hz].            */
+#define MIN_PERIOD        (4000)              /*!< Default minimum STEP period in clock cycles. */
+
+/* Curve (easing) segments */
+#define CURVE_LINEAR      (0)
+#define CURVE_EASE_IN_OUT (1)
+#define CURVE_EASE_IN     (2)
+#define CURVE_EASE_OUT    (3)
+#define CURVE_CUSTOM      (4)
+
+/* Minimum STEP period in clock cycles (MIN_PERIOD or measured by the step rate self-test) */
+extern uint32_t planner_min_period;
+
+/* Curve control ordinates (in [1/1000]) for CURVE_LINEAR .. CURVE_EASE_OUT */
+extern const int planner_curve_p[CURVE_CUSTOM][2];
+
+uint32_t planner_hperiod(uint64_t period);
+uint64_t planner_duration_period(int duration, int xSteps);
+uint32_t planner_duration_hperiod(int duration, int xSteps);
+uint32_t planner_speed_hperiod(int speed);
+uint32_t planner_override(uint32_t hperiod, int percent);
+int      planner_speed_duration(int xSteps, int speed);
+int      planner_clamp(int pos, int max);
+int      planner_brake_steps(uint32_t hperiod);
+uint64_t planner_move_cycles(int xSteps, uint32_t hperiod);
+int64_t  planner_curve(int64_t s, int64_t p1, int64_t p2);
+int      planner_curve_ordinate(int p);
+int      planner_auto_shift(uint64_t fperiod, int ushift, int smax);
+
+#ifdef USE_RAMP
+/*!
+ * \brief Tabled ramp - one step of the step generator (executed after every STEP pulse).
+ * Tracks target half period (both directions) and brakes before target,
+ * ramp table index is derived from the half period.
+ * \param h         - current half period (updated),
+ * \param target    - target (cruise) half period,
+ * \param iter      - steps left on the current ramp level (updated),
+ * \param brake     - steps needed to decelerate to start/stop speed (updated),
+ * \param remaining - steps left to the target position.
+ * \return 1 when the half period was changed.
+ */
+static inline __attribute__((always_inline)) int planner_ramp_step(uint32_t *h, uint32_t target, int *iter, int *brake, int remaining)
+{
+	uint32_t l = *h;
+
+	if (l >= RSTART_STOP_HPERIOD) {
+		/* Below start/stop speed - change speed without ramp */
+		if (target >= RSTART_STOP_HPERIOD) {
+			if (l == target) return 0;
+			*h = target;
+			return 1;
+		}
+		if (l != RSTART_STOP_HPERIOD) {
+			*h     = RSTART_STOP_HPERIOD;
+			*iter  = 0;
+			*brake = 0;
+			return 1;
+		}
+	}
+	if ((remaining <= *brake) || (l < target)) {
+		/* Ramp DOWN */
+		if (*brake) (*brake)--;
+		if (l < RSTART_STOP_HPERIOD) {
+			if (*iter == 0) {
+				l++;
+				*h    = l;
+				*iter = (l < RSTART_STOP_HPERIOD) ? ramp[RSTART_STOP_HPERIOD - 1 - l] : 0;
+				return 1;
+			}
+			(*iter)--;
+		}
+	} else if (l > target) {
+		/* Ramp UP */
+		(*brake)++;
+		if (*iter == 0) {
+			l--;
+			*h    = l;
+			*iter = ramp[RSTART_STOP_HPERIOD - 1 - l];
+			return 1;
+		}
+		(*iter)--;
+	}
+	return 0;
+}
+#endif
+
+#endif //__PLANNER_H__
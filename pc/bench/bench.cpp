@@ -0,0 +1,151 @@
+/*
+ * Host microbenchmarks of the command streaming path (parser, queues, planner).
+ * Built against the host build of the firmware (pc/host), results in [ns/op] are written
+ * as JSON (one object per benchmark) so they can be compared between builds.
+ *
+ * build: g++ -O2 -std=gnu++17 -Ipc/host -Iinclude -Ilib/Planner/src -o pc/bench/bench \
+ *        pc/bench/bench.cpp pc/host/HostSim.cpp src/main.cpp src/Motion1D.cpp src/Command.cpp \
+ *        src/NetworkCommand.cpp src/HTTPCommand.cpp src/FileCommand.cpp src/TMC2208Uart.cpp lib/Planner/src/Planner.cpp lib/Planner/src/ramp.cpp
+ *
+ * usage: bench [-n iterations] [-r repeats] [-o output.json]
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+#include "Arduino.h"
+#include "Motion1D.h"
+#include "NetworkCommand.h"
+
+#define BATCH (32)                            /*!< Queued commands between queue flushes.   */
+
+extern Motion1D       *m1d;
+extern CommandDB       CmdDB;
+extern NetworkCommand *NCmd;
+void setup();
+
+typedef struct bench_result_s {
+	const char *name;
+	double      ns;                           /*!< Best [ns/op] of all repeats.             */
+	uint64_t    n;                            /*!< Operations per repeat.                   */
+} bench_result_t;
+
+static volatile uint32_t g_sink;              /*!< Keeps results alive.                     */
+
+/*!
+ * \brief Run fn(batch) until n operations were done, return best time per operation of r repeats.
+ * fn returns the time spent in the measured part in [ns].
+ */
+static double measure(uint64_t n, int r, std::function<uint64_t(void)> fn)
+{
+	double best = 1e30;
+
+	for (int k = 0; k < r; ++k) {
+		uint64_t ns = 0;
+		for (uint64_t i = 0; i < n; i += BATCH) ns += fn();
+		if (((double)ns / n) < best) best = (double)ns / n;
+	}
+	return best;
+}
+//====================================================================================
+
+static uint64_t nsNow()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+//====================================================================================
+
+int main(int argc, char **argv)
+{
+	std::vector<bench_result_t> res;
+	uint64_t    n = 1 << 20, m;
+	int         r = 5, opt;
+	const char *out = NULL;
+	FILE       *f = stdout;
+
+	while ((opt = getopt(argc, argv, "n:r:o:")) != -1) {
+		switch (opt) {
+			case 'n': n = strtoull(optarg, NULL, 10); break;
+			case 'r': r = atoi(optarg); break;
+			case 'o': out = optarg; break;
+			default:
+				fprintf(stderr, "usage: %s [-n iterations] [-r repeats] [-o output.json]\n", argv[0]);
+				return 1;
+		}
+	}
+	n = (n + BATCH - 1) / BATCH * BATCH;
+	/* Real command database and motion controller */
+	setup();
+
+	/* Parse and dispatch motion command (CommandDB::executeCommand + CommandQueueItem) */
+	res.push_back({"CommandDB::executeCommand", measure(n, r, []() {
+		char     line[BATCH][COMMAND_BUFFER + 1];
+		uint64_t t;
+		for (int i = 0; i < BATCH; ++i) strcpy(line[i], "GTR,1000,3200");
+		t = nsNow();
+		for (int i = 0; i < BATCH; ++i) CmdDB.executeCommand(NCmd, line[i]);
+		t = nsNow() - t;
+		CmdDB.m_motionQueue.clear();
+		return t;
+	}), n});
+
+	/* Argument parser only */
+	res.push_back({"CommandQueueItem::CommandQueueItem", measure(n, r, []() {
+		char     args[BATCH][COMMAND_BUFFER + 1];
+		uint64_t t;
+		for (int i = 0; i < BATCH; ++i) strcpy(args[i], "1000,3200,5");
+		t = nsNow();
+		for (int i = 0; i < BATCH; ++i) {
+			CommandQueueItem c(NCmd, args[i], NULL);
+			g_sink += c.m_arg2;
+		}
+		return nsNow() - t;
+	}), n});
+
+	/* Motion queue entry round trip (NOP entries are skipped by the pull) */
+	res.push_back({"Motion1D::motionQ_push+pull", measure(n, r, []() {
+		uint64_t t = nsNow();
+		for (int i = 0; i < BATCH; ++i) m1d->motionQ_push(MOTION_CMD_NOP, i, i);
+		for (int i = 0; i < BATCH; ++i) m1d->motionQ_pull();
+		return nsNow() - t;
+	}), n});
+
+	/* Planning only (duration solver) */
+	res.push_back({"planner_duration_hperiod", measure(n, r, []() {
+		uint64_t t = nsNow();
+		for (int i = 0; i < BATCH; ++i) g_sink += planner_duration_hperiod(1000 + i, 3200 + (i << 4));
+		return nsNow() - t;
+	}), n});
+
+	/* Planning and start of the step generator (n / BATCH moves, the step generator is stopped between moves - not measured) */
+	m = (n / BATCH + BATCH - 1) / BATCH * BATCH;
+	res.push_back({"Motion1D::goToReal", measure(m, r, []() {
+		uint64_t t, ns = 0;
+		for (int i = 0; i < BATCH; ++i) {
+			t = nsNow();
+			m1d->goToReal(1000, m1d->fromMicrosteps(3200));
+			ns += nsNow() - t;
+			m1d->stop();
+		}
+		return ns;
+	}), m});
+
+	if ((out) && ((f = fopen(out, "w")) == NULL)) {
+		perror(out);
+		return 1;
+	}
+	fprintf(f, "[\n");
+	for (size_t i = 0; i < res.size(); ++i) {
+		fprintf(f, "  {\"name\": \"%s\", \"ns_per_op\": %.2f, \"iterations\": %llu, \"repeats\": %d}%s\n", \
+			res[i].name, res[i].ns, (unsigned long long)res[i].n, r, (i + 1 < res.size()) ? "," : "");
+	}
+	fprintf(f, "]\n");
+	if (f != stdout) fclose(f);
+	return 0;
+}
+//====================================================================================
@@ -0,0 +1,146 @@
+/*
+ * Host (PC) replacement of the Arduino core - just enough to build the slider firmware
+ * against the simulated hardware in HostSim.cpp.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <string>
+#include <functional>
+#include "HostSim.h"
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH         (1)
+#define LOW          (0)
+#define INPUT        (0)
+#define OUTPUT       (1)
+#define INPUT_PULLUP (2)
+#define RISING       (1)
+#define FALLING      (2)
+#define CHANGE       (3)
+#define DEC          (10)
+#define HEX          (16)
+#define F_CPU        (80000000L)
+
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+#define PROGMEM
+
+/*!
+ * \brief Arduino String on top of std::string.
+ */
+class String: public std::string {
+public:
+	String() {}
+	String(const char *s): std::string(s ? s : "") {}
+	String(const std::string &s): std::string(s) {}
+	String(char c): std::string(1, c) {}
+	String(int v, int base = DEC): std::string(format((long long)v, base)) {}
+	String(unsigned int v, int base = DEC): std::string(format((unsigned long long)v, base)) {}
+	String(long v, int base = DEC): std::string(format((long long)v, base)) {}
+	String(unsigned long v, int base = DEC): std::string(format((unsigned long long)v, base)) {}
+	String(long long v, int base = DEC): std::string(format(v, base)) {}
+	String(unsigned long long v, int base = DEC): std::string(format(v, base)) {}
+	String(float v, int dec = 2): std::string(format((double)v, dec)) {}
+	String(double v, int dec = 2): std::string(format(v, dec)) {}
+
+	int toInt() const {return atoi(c_str());}
+	bool startsWith(const char *p) const {return compare(0, strlen(p), p) == 0;}
+	bool endsWith(const char *p) const {size_t n = strlen(p); return (length() >= n) && (compare(length() - n, n, p) == 0);}
+	int indexOf(char c) const {size_t i = find(c); return (i == npos) ? -1 : (int)i;}
+	String substring(int a, int b = -1) const {return (b < 0) ? String(substr(a)) : String(substr(a, b - a));}
+	String &operator+=(const String &s) {append(s); return *this;}
+	String &operator+=(const char *s) {append(s); return *this;}
+	String &operator+=(char c) {push_back(c); return *this;}
+private:
+	static std::string format(long long v, int base) {
+		char b[32];
+		if (base == HEX) snprintf(b, sizeof(b), "%llx", (unsigned long long)v); else snprintf(b, sizeof(b), "%lld", v);
+		return b;
+	}
+	static std::string format(unsigned long long v, int base) {
+		char b[32];
+		snprintf(b, sizeof(b), (base == HEX) ? "%llx" : "%llu", v);
+		return b;
+	}
+	static std::string format(double v, int dec) {
+		char b[64];
+		snprintf(b, sizeof(b), "%.*f", dec, v);
+		return b;
+	}
+};
+inline String operator+(const String &a, const String &b) {return String((const std::string &)a + (const std::string &)b);}
+inline String operator+(const String &a, const char *b) {return String((const std::string &)a + b);}
+inline String operator+(const char *a, const String &b) {return String(a + (const std::string &)b);}
+
+class Stream {
+public:
+	virtual ~Stream() {}
+	virtual int available() {return 0;}
+	virtual int read() {return -1;}
+	virtual size_t write(uint8_t c) {return 1;}
+	virtual size_t write(const uint8_t *buf, size_t n) {return n;}
+	void flush() {}
+	size_t print(const String &s) {return write((const uint8_t *)s.c_str(), s.length());}
+	size_t print(const char *s) {return write((const uint8_t *)s, strlen(s));}
+	size_t print(int v) {return print(String(v));}
+	size_t println(const String &s) {return print(s + "\r\n");}
+	size_t printf(const char *fmt, ...) __attribute__ ((format (printf, 2, 3))) {
+		char    b[256];
+		va_list arg;
+		va_start(arg, fmt);
+		vsnprintf(b, sizeof(b), fmt, arg);
+		va_end(arg);
+		return print(b);
+	}
+};
+
+/*!
+ * \brief Serial port - connected to the simulated TMC2208 single wire UART (HostSim.cpp).
+ */
+class HardwareSerial: public Stream {
+public:
+	void begin(unsigned long baud) {}
+	void setRxBufferSize(size_t n) {}
+	virtual int available() {return host_uart_available();}
+	virtual int read() {return host_uart_read();}
+	virtual size_t write(uint8_t c) {host_uart_write(c); return 1;}
+	virtual size_t write(const uint8_t *buf, size_t n) {for (size_t i = 0; i < n; ++i) host_uart_write(buf[i]); return n;}
+};
+extern HardwareSerial Serial;
+
+/* Time and GPIO are taken from the simulated hardware */
+inline unsigned long millis() {return (unsigned long)(host_now / (HOST_CLOCK / 1000));}
+inline unsigned long micros() {return (unsigned long)(host_now / (HOST_CLOCK / 1000000));}
+inline void delay(unsigned long ms) {host_run((uint64_t)ms * (HOST_CLOCK / 1000));}
+inline void delayMicroseconds(unsigned int us) {host_run((uint64_t)us * (HOST_CLOCK / 1000000));}
+inline void yield() {host_run(HOST_YIELD_CYCLES);}
+inline void pinMode(int pin, int mode) {if (mode == INPUT_PULLUP) host_pin_input(pin, HIGH);}
+inline void digitalWrite(int pin, int level) {host_pin_write(pin, level);}
+inline int  digitalRead(int pin) {return host_pin_level(pin);}
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void attachInterrupt(int irq, void (*isr)(void), int mode) {host_pin_attach(irq, isr, mode);}
+inline void detachInterrupt(int irq) {host_pin_attach(irq, NULL, 0);}
+inline int  digitalPinToInterrupt(int pin) {return pin;}
+
+inline char *itoa(int v, char *b, int base) {snprintf(b, 33, (base == HEX) ? "%x" : "%d", v); return b;}
+template<class T> T min(T a, T b) {return (a < b) ? a : b;}
+template<class T> T max(T a, T b) {return (a > b) ? a : b;}
+#define constrain(x, a, b) (((x) < (a)) ? (a) : (((x) > (b)) ? (b) : (x)))
+
+#endif //__HOST_ARDUINO_H__
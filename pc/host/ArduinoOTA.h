@@ -0,0 +1,24 @@
+/*
+ * Host (PC) replacement of <ArduinoOTA.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ARDUINOOTA_H__
+#define __HOST_ARDUINOOTA_H__
+
+#include <functional>
+
+class OTAClass {
+public:
+	void setHostname(const char *name) {}
+	void onStart(std::function<void()> fn) {}
+	void begin() {}
+	void handle() {}
+};
+extern OTAClass ArduinoOTA;
+
+#endif //__HOST_ARDUINOOTA_H__
@@ -0,0 +1,21 @@
+/*
+ * Host (PC) replacement of <DNSServer.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_DNSSERVER_H__
+#define __HOST_DNSSERVER_H__
+
+#include "ESP8266WiFi.h"
+
+class DNSServer {
+public:
+	void start(int port, const char *domain, IPAddress ip) {}
+	void processNextRequest() {}
+};
+
+#endif //__HOST_DNSSERVER_H__
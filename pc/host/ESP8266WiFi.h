@@ -0,0 +1,37 @@
+/*
+ * Host (PC) replacement of <ESP8266WiFi.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ESP8266WIFI_H__
+#define __HOST_ESP8266WIFI_H__
+
+#include "Arduino.h"
+
+#define WIFI_STA     (1)
+#define WL_CONNECTED (3)
+
+class IPAddress {
+public:
+	String toString() {return "127.0.0.1";}
+};
+
+class WiFiClass {
+public:
+	void hostname(const char *name) {}
+	void mode(int m) {}
+	void disconnect() {}
+	void begin() {}
+	void begin(const char *ssid, const char *pass) {}
+	int status() {return WL_CONNECTED;}
+	void softAP(const char *ssid) {}
+	IPAddress softAPIP() {return IPAddress();}
+	IPAddress localIP() {return IPAddress();}
+};
+extern WiFiClass WiFi;
+
+#endif //__HOST_ESP8266WIFI_H__
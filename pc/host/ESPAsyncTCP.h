@@ -0,0 +1,39 @@
+/*
+ * Host (PC) replacement of <ESPAsyncTCP.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ESPASYNCTCP_H__
+#define __HOST_ESPASYNCTCP_H__
+
+#include "Arduino.h"
+
+/*!
+ * \brief TCP client - data sent by the firmware is passed to the onHostData callback.
+ */
+class AsyncClient {
+public:
+	typedef std::function<void(void *arg, AsyncClient *client)> AcConnectHandler;
+	typedef std::function<void(void *arg, AsyncClient *client, void *data, size_t len)> AcDataHandler;
+	void setNoDelay(bool v) {}
+	void onDisconnect(AcConnectHandler cb, void *arg) {}
+	void onData(AcDataHandler cb, void *arg) {}
+	size_t add(const char *data, size_t len) {if (onHostData) onHostData(data, len); return len;}
+	bool send() {return true;}
+public:
+	std::function<void(const char *data, size_t len)> onHostData;
+};
+
+class AsyncServer {
+public:
+	typedef std::function<void(void *arg, AsyncClient *client)> AcConnectHandler;
+	AsyncServer(int port) {}
+	void onClient(AcConnectHandler cb, void *arg) {}
+	void begin() {}
+};
+
+#endif //__HOST_ESPASYNCTCP_H__
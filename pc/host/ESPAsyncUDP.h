@@ -0,0 +1,18 @@
+/*
+ * Host (PC) replacement of <ESPAsyncUDP.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ESPASYNCUDP_H__
+#define __HOST_ESPASYNCUDP_H__
+
+class AsyncUDP {
+public:
+	void broadcastTo(const char *data, int port) {}
+};
+
+#endif //__HOST_ESPASYNCUDP_H__
@@ -0,0 +1,64 @@
+/*
+ * Host (PC) replacement of <ESPAsyncWebServer.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_ESPASYNCWEBSERVER_H__
+#define __HOST_ESPASYNCWEBSERVER_H__
+
+#include "Arduino.h"
+
+enum {HTTP_GET = 1, HTTP_POST = 2};
+
+class AsyncWebParameter {
+public:
+	String value() {return m_value;}
+	String m_value;
+};
+
+class AsyncWebServerResponse {
+public:
+	void addHeader(const char *name, const char *value) {}
+};
+
+class AsyncWebServerRequest {
+public:
+	bool hasParam(const char *name, bool post = false, bool file = false) {return false;}
+	AsyncWebParameter *getParam(const char *name, bool post = false, bool file = false) {return &m_param;}
+	AsyncWebServerResponse *beginResponse_P(int code, const char *type, const uint8_t *data, size_t len) {return &m_response;}
+	void send(int code, const char *type, const String &text) {}
+	void send(AsyncWebServerResponse *response) {}
+	AsyncWebParameter      m_param;
+	AsyncWebServerResponse m_response;
+};
+
+class AsyncEventSourceClient {
+public:
+	void send(const char *message, const char *event, uint32_t id, uint32_t reconnect) {}
+};
+
+class AsyncEventSource {
+public:
+	AsyncEventSource(const char *url) {}
+	void send(const char *message, const char *event) {}
+	void onConnect(std::function<void(AsyncEventSourceClient *client)> cb) {}
+};
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data, size_t len, bool final)> ArUploadHandlerFunction;
+
+class AsyncWebServer {
+public:
+	AsyncWebServer(int port) {}
+	void on(const char *uri, int method, ArRequestHandlerFunction fn) {}
+	void on(const char *uri, int method, ArRequestHandlerFunction fn, ArUploadHandlerFunction upload) {}
+	void onNotFound(ArRequestHandlerFunction fn) {}
+	void addHandler(AsyncEventSource *events) {}
+	void begin() {}
+};
+
+#endif //__HOST_ESPASYNCWEBSERVER_H__
@@ -0,0 +1,380 @@
+/*
+ * Simulated ESP8266 hardware for host builds of the firmware (pc/replay, pc/bench).
+ *
+ * Timer1 model: writing the load register (RTC_REG_WRITE) restarts the count, otherwise
+ * the timer reloads automatically (AUTORELOAD mode). Interrupts are executed at the exact
+ * simulated time, so the STEP/DIR trace is deterministic.
+ *
+ * TMC2208 UART model: single wire bus (every sent byte is echoed), datagrams addressed to
+ * slave 0 with valid CRC are executed, read replies are sent after SENDDELAY (8 bit times).
+ * MSCNT follows STEP pulses (DIR high - up) with the step size of CHOPCONF.MRES, while VACTUAL
+ * is not 0 the STEP input is ignored and MSCNT is moved by the internal step generator
+ * (HOST_TMC_CLOCK - slightly off the nominal 12MHz, like a real chip). Write datagrams can be
+ * dropped (noise on the bus), the sender sees them transmitted.
+ *
+ * Encoder model: the motor position follows MSCNT changes (slip moves it without changing
+ * MSCNT, like a rotor jumping by whole electrical cycles), an attached quadrature encoder
+ * drives its A/B inputs (pin interrupts) one count at a time.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "ArduinoOTA.h"
+#include "LittleFS.h"
+
+#define TIMER1_LOAD   (0)
+#define TIMER1_CTRL   (2)
+#define TIMER1_ENABLE (0x80)
+#define GPIO_W1TS     (1)
+#define GPIO_W1TC     (2)
+#define TMC_GSTAT     (0x01)
+#define TMC_IFCNT     (0x02)
+#define TMC_VACTUAL   (0x22)
+#define TMC_MSCNT     (0x6A)
+#define TMC_CHOPCONF  (0x6C)
+
+uint64_t       host_now = 0;
+uint32_t       host_timer1_regs[16];
+uint32_t       host_gpio_regs[16];
+uint32_t       host_tmc_regs[128];
+
+HardwareSerial Serial;
+WiFiClass      WiFi;
+OTAClass       ArduinoOTA;
+FS             LittleFS;
+
+static void     (*host_timer1_isr)(void) = NULL;
+static uint64_t   host_timer1_next      = 0;
+static bool       host_timer1_running   = false;
+static HostPinCB  host_pin_cb;
+static int        host_pin[HOST_PINS];
+static void     (*host_pin_isr[HOST_PINS])(void);
+static int        host_pin_mode[HOST_PINS];
+static uint8_t    host_uart_in[8];                   /*!< Received datagram.                   */
+static int        host_uart_in_n        = 0;
+static uint64_t   host_uart_tx_end      = 0;         /*!< End of the last byte on the bus.     */
+static uint8_t    host_uart_rx[256];                 /*!< Bytes on the bus (echo and replies). */
+static uint64_t   host_uart_rx_t[256];               /*!< Time the byte is received.           */
+static uint8_t    host_uart_rx_wr       = 0;
+static uint8_t    host_uart_rx_rd       = 0;
+static uint64_t   host_tmc_vt           = 0;         /*!< VACTUAL integrated up to this time.  */
+static double     host_tmc_vacc         = 0;         /*!< VACTUAL microstep fraction.          */
+static int64_t    host_tmc_pos          = 0;         /*!< Motor position in 1/256 microsteps.  */
+static int        host_tmc_drop         = 0;         /*!< Write datagrams to ignore (noise).   */
+static int        host_tmc_drop_reg     = -1;        /*!< Only writes of this register (-1 - any). */
+static int        host_enc_a            = -1;        /*!< Encoder A pin (-1 - no encoder).     */
+static int        host_enc_b            = -1;        /*!< Encoder B pin.                       */
+static int        host_enc_units        = 1;         /*!< Scale - 1/256 microsteps per host_enc_counts. */
+static int        host_enc_counts       = 0;         /*!< Scale - encoder counts.              */
+static int64_t    host_enc_n            = 0;         /*!< Encoder count on the A/B pins.       */
+/* A/B levels (A - bit 1) of count & 3, pull-up level (11) at count 0 */
+static const int  host_enc_gray[4]      = {3, 2, 0, 1};
+
+/*!
+ * \brief TMC2208 register reset values (GCONF, GSTAT, IHOLD_IRUN, TPOWERDOWN, CHOPCONF, PWMCONF).
+ */
+static struct host_tmc_reset_s {
+	host_tmc_reset_s() {
+		host_tmc_regs[0x00] = 0x00000101;
+		host_tmc_regs[0x01] = 0x00000001;
+		host_tmc_regs[0x10] = 0x00011F08;
+		host_tmc_regs[0x11] = 20;
+		host_tmc_regs[0x6C] = 0x10000053;
+		host_tmc_regs[0x70] = 0xC10D0024;
+	}
+} host_tmc_reset;
+
+void host_timer1_attach(void (*isr)(void))
+{
+	host_timer1_isr = isr;
+}
+//====================================================================================
+
+void host_timer1_load(uint32_t v)
+{
+	host_timer1_regs[TIMER1_LOAD] = v;
+	host_timer1_next              = host_now + v;
+}
+//====================================================================================
+
+void host_on_pin(HostPinCB cb)
+{
+	host_pin_cb = cb;
+}
+//====================================================================================
+
+/*!
+ * \brief Encoder count at the motor position.
+ */
+static int64_t host_enc_count()
+{
+	int64_t p = host_tmc_pos * host_enc_counts;
+
+	return (p >= 0) ? (p / host_enc_units) : -((-p + host_enc_units - 1) / host_enc_units);
+}
+//====================================================================================
+
+/*!
+ * \brief Drive encoder A/B pins to the motor position (one count per edge).
+ */
+static void host_enc_update()
+{
+	int64_t n;
+
+	if (host_enc_a < 0) return;
+	n = host_enc_count();
+	while (host_enc_n != n) {
+		host_enc_n += (n > host_enc_n) ? 1 : -1;
+		host_pin_input(host_enc_a, host_enc_gray[host_enc_n & 3] >> 1);
+		host_pin_input(host_enc_b, host_enc_gray[host_enc_n & 3] & 1);
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Attach quadrature encoder model (units - 1/256 microsteps per counts, counts < 0 - reversed).
+ */
+void host_encoder_attach(int pinA, int pinB, int units, int counts)
+{
+	host_enc_units  = units;
+	host_enc_counts = counts;
+	host_enc_n      = host_enc_count();
+	host_enc_a      = pinA;
+	host_enc_b      = pinB;
+	host_pin_input(host_enc_a, host_enc_gray[host_enc_n & 3] >> 1);
+	host_pin_input(host_enc_b, host_enc_gray[host_enc_n & 3] & 1);
+}
+//====================================================================================
+
+/*!
+ * \brief Motor slips by d (in 1/256 microsteps) - MSCNT is not changed (lost steps).
+ */
+void host_tmc_slip(int d)
+{
+	host_tmc_pos += d;
+	host_enc_update();
+}
+//====================================================================================
+
+/*!
+ * \brief The next n write datagrams (of register reg, -1 - any) are lost (not executed, IFCNT is not incremented).
+ */
+void host_tmc_drop_writes(int n, int reg)
+{
+	host_tmc_drop     = n;
+	host_tmc_drop_reg = reg;
+}
+//====================================================================================
+
+/*!
+ * \brief Driver moves the motor by d (in 1/256 microsteps).
+ */
+static void host_tmc_move(int d)
+{
+	host_tmc_regs[TMC_MSCNT] = (host_tmc_regs[TMC_MSCNT] + d) & 1023;
+	host_tmc_pos            += d;
+	host_enc_update();
+}
+//====================================================================================
+
+/*!
+ * \brief Move MSCNT by the internal step generator (VACTUAL) up to time t.
+ */
+static void host_tmc_vactual(uint64_t t)
+{
+	int32_t v = ((int32_t)(host_tmc_regs[TMC_VACTUAL] << 8)) >> 8;
+	int     s = 1 << ((host_tmc_regs[TMC_CHOPCONF] >> 24) & 0xf);
+	int     n;
+
+	if (t <= host_tmc_vt) return;
+	if ((v) && (!host_pin[HOST_TMC_EN])) {
+		host_tmc_vacc += ((double)v * HOST_TMC_CLOCK / 16777216.0) * (double)(t - host_tmc_vt) / HOST_CLOCK;
+		n              = (int)host_tmc_vacc;
+		host_tmc_vacc -= n;
+		host_tmc_move(n * s);
+	}
+	host_tmc_vt = t;
+}
+//====================================================================================
+
+void host_pin_write(int pin, int level)
+{
+	if ((pin < 0) || (pin >= HOST_PINS) || (host_pin[pin] == level)) return;
+	host_pin[pin] = level;
+	if ((pin == HOST_TMC_STEP) && (level) && (!host_pin[HOST_TMC_EN]) && (host_tmc_regs[TMC_VACTUAL] == 0)) {
+		int s = 1 << ((host_tmc_regs[TMC_CHOPCONF] >> 24) & 0xf);
+		host_tmc_move((host_pin[HOST_TMC_DIR]) ? s : -s);
+	}
+	if (host_pin_cb) host_pin_cb(host_now, pin, level);
+}
+//====================================================================================
+
+/*!
+ * \brief Drive input pin (endstop, ...) - pin interrupt is executed on a matching edge.
+ */
+void host_pin_input(int pin, int level)
+{
+	int old;
+
+	if ((pin < 0) || (pin >= HOST_PINS)) return;
+	old           = host_pin[pin];
+	host_pin[pin] = level;
+	if ((old == level) || (host_pin_isr[pin] == NULL)) return;
+	if ((host_pin_mode[pin] == CHANGE) || ((host_pin_mode[pin] == RISING) && (level)) || ((host_pin_mode[pin] == FALLING) && (!level))) {
+		host_pin_isr[pin]();
+	}
+}
+//====================================================================================
+
+int host_pin_level(int pin)
+{
+	return ((pin >= 0) && (pin < HOST_PINS)) ? host_pin[pin] : 0;
+}
+//====================================================================================
+
+void host_pin_attach(int pin, void (*isr)(void), int mode)
+{
+	if ((pin < 0) || (pin >= HOST_PINS)) return;
+	host_pin_isr[pin]  = isr;
+	host_pin_mode[pin] = mode;
+}
+//====================================================================================
+
+/*!
+ * \brief Apply GPIO set/clear register writes to the pins.
+ */
+static void host_gpio_sync()
+{
+	uint32_t s = host_gpio_regs[GPIO_W1TS];
+	uint32_t c = host_gpio_regs[GPIO_W1TC];
+
+	host_gpio_regs[GPIO_W1TS] = 0;
+	host_gpio_regs[GPIO_W1TC] = 0;
+	for (int i = 0; i < HOST_PINS; ++i) {
+		if (s & (1u << i)) host_pin_write(i, 1);
+		if (c & (1u << i)) host_pin_write(i, 0);
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Advance simulated time, execute Timer1 interrupts.
+ */
+void host_run(uint64_t cycles)
+{
+	uint64_t end = host_now + cycles;
+
+	host_gpio_sync();
+	for (;;) {
+		if (!(host_timer1_regs[TIMER1_CTRL] & TIMER1_ENABLE)) {
+			host_timer1_running = false;
+			break;
+		}
+		if (!host_timer1_running) {
+			/* Timer started without new load value */
+			host_timer1_running = true;
+			if (host_timer1_next < host_now) host_timer1_next = host_now + host_timer1_regs[TIMER1_LOAD];
+		}
+		if ((host_timer1_isr == NULL) || (host_timer1_next > end)) break;
+		host_now          = host_timer1_next;
+		host_timer1_next += (host_timer1_regs[TIMER1_LOAD]) ? host_timer1_regs[TIMER1_LOAD] : 1;
+		host_timer1_isr();
+		host_gpio_sync();
+	}
+	host_now = end;
+	/* Encoder follows the internal step generator */
+	if (host_enc_a >= 0) host_tmc_vactual(host_now);
+}
+//====================================================================================
+
+static uint8_t host_tmc_crc(const uint8_t *data, int len)
+{
+	uint8_t crc = 0, b;
+
+	for (int i = 0; i < len; ++i) {
+		b = data[i];
+		for (int j = 0; j < 8; ++j) {
+			crc = ((crc >> 7) ^ (b & 0x01)) ? ((crc << 1) ^ 0x07) : (crc << 1);
+			b >>= 1;
+		}
+	}
+	return crc;
+}
+//====================================================================================
+
+/*!
+ * \brief Put byte on the bus (received by the MCU after its transmission time).
+ */
+static void host_uart_bus(uint8_t c, uint64_t t)
+{
+	host_uart_tx_end                 = t + HOST_UART_BYTE;
+	host_uart_rx[host_uart_rx_wr]    = c;
+	host_uart_rx_t[host_uart_rx_wr++] = host_uart_tx_end;
+}
+//====================================================================================
+
+/*!
+ * \brief MCU sends byte - echo it and execute complete datagrams.
+ */
+void host_uart_write(uint8_t c)
+{
+	uint8_t  r[8];
+	uint32_t v;
+
+	host_uart_bus(c, (host_uart_tx_end > host_now) ? host_uart_tx_end : host_now);
+	if ((host_uart_in_n == 0) && (c != 0x05)) return;
+	host_uart_in[host_uart_in_n++] = c;
+	if ((host_uart_in_n == 4) && (!(host_uart_in[2] & 0x80))) {
+		host_uart_in_n = 0;
+		if ((host_uart_in[1] != 0) || (host_tmc_crc(host_uart_in, 3) != host_uart_in[3])) return;
+		host_tmc_vactual(host_uart_tx_end);
+		v    = host_tmc_regs[host_uart_in[2] & 0x7f];
+		r[0] = 0x05; r[1] = 0xFF; r[2] = host_uart_in[2];
+		r[3] = v >> 24; r[4] = v >> 16; r[5] = v >> 8; r[6] = v;
+		r[7] = host_tmc_crc(r, 7);
+		/* SENDDELAY */
+		host_uart_tx_end += (HOST_UART_BYTE * 8) / 10;
+		for (int i = 0; i < 8; ++i) host_uart_bus(r[i], host_uart_tx_end);
+		return;
+	}
+	if (host_uart_in_n == 8) {
+		host_uart_in_n = 0;
+		if ((host_uart_in[1] != 0) || (host_tmc_crc(host_uart_in, 7) != host_uart_in[7])) return;
+		if ((host_tmc_drop) && ((host_tmc_drop_reg < 0) || (host_tmc_drop_reg == (host_uart_in[2] & 0x7f)))) {
+			host_tmc_drop--;
+			return;
+		}
+		v = ((uint32_t)host_uart_in[3] << 24) | ((uint32_t)host_uart_in[4] << 16) | ((uint32_t)host_uart_in[5] << 8) | host_uart_in[6];
+		host_tmc_vactual(host_uart_tx_end);
+		if (((host_uart_in[2] & 0x7f) == TMC_VACTUAL) && (v == 0)) host_tmc_vacc = 0;
+		if ((host_uart_in[2] & 0x7f) == TMC_GSTAT) {
+			/* Write 1 to clear */
+			host_tmc_regs[TMC_GSTAT] &= ~v;
+		} else {
+			host_tmc_regs[host_uart_in[2] & 0x7f] = v;
+		}
+		host_tmc_regs[TMC_IFCNT] = (host_tmc_regs[TMC_IFCNT] + 1) & 0xff;
+	}
+}
+//====================================================================================
+
+int host_uart_available()
+{
+	int n = 0;
+
+	for (uint8_t i = host_uart_rx_rd; (i != host_uart_rx_wr) && (host_uart_rx_t[i] <= host_now); ++i) n++;
+	return n;
+}
+//====================================================================================
+
+int host_uart_read()
+{
+	if ((host_uart_rx_rd == host_uart_rx_wr) || (host_uart_rx_t[host_uart_rx_rd] > host_now)) return -1;
+	return host_uart_rx[host_uart_rx_rd++];
+}
+//====================================================================================
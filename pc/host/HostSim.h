@@ -0,0 +1,53 @@
+/*
+ * Simulated ESP8266 hardware for host builds of the firmware (pc/replay, pc/bench).
+ * Time runs in timer1 clock cycles (80MHz), Timer1 and GPIO registers are plain memory,
+ * the serial port is connected to a TMC2208 UART register model, an optional quadrature
+ * encoder follows the motor position.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_SIM_H__
+#define __HOST_SIM_H__
+
+#include <stdint.h>
+#include <functional>
+
+#define HOST_CLOCK        (80000000ull)       /*!< Simulated CPU/timer1 clock in [Hz].      */
+#define HOST_YIELD_CYCLES (800)               /*!< Time spent in yield() (10us).            */
+#define HOST_PINS         (17)
+#define HOST_TMC_STEP     (14)                /*!< TMC2208 STEP, DIR and EN pins (main.cpp). */
+#define HOST_TMC_DIR      (13)
+#define HOST_TMC_EN       (2)
+#define HOST_TMC_CLOCK    (12240000.0)        /*!< TMC2208 internal clock in [Hz] (VACTUAL). */
+#define HOST_UART_BYTE    (HOST_CLOCK * 10 / 115200)  /*!< UART byte time (115200 baud).  */
+
+extern uint64_t host_now;                     /*!< Simulated time in clock cycles.          */
+extern uint32_t host_timer1_regs[16];         /*!< Timer1 registers (0x60000600).           */
+extern uint32_t host_gpio_regs[16];           /*!< GPIO registers (0x60000300).             */
+extern uint32_t host_tmc_regs[128];           /*!< TMC2208 registers.                       */
+
+/*!
+ * \brief Output pin change callback (time, pin, level).
+ */
+typedef std::function<void(uint64_t t, int pin, int level)> HostPinCB;
+
+void host_timer1_attach(void (*isr)(void));
+void host_timer1_load(uint32_t v);
+void host_run(uint64_t cycles);
+void host_on_pin(HostPinCB cb);
+void host_pin_write(int pin, int level);
+void host_pin_input(int pin, int level);
+int  host_pin_level(int pin);
+void host_pin_attach(int pin, void (*isr)(void), int mode);
+void host_encoder_attach(int pinA, int pinB, int units, int counts);
+void host_tmc_slip(int d);
+void host_tmc_drop_writes(int n, int reg = -1);
+void host_uart_write(uint8_t c);
+int  host_uart_available();
+int  host_uart_read();
+
+#endif //__HOST_SIM_H__
@@ -0,0 +1,95 @@
+/*
+ * Host (PC) replacement of <LittleFS.h> - in-memory file system for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_LITTLEFS_H__
+#define __HOST_LITTLEFS_H__
+
+#include "Arduino.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+typedef std::shared_ptr<std::string> HostFileData;
+
+class File: public Stream {
+public:
+	File(): m_pos(0) {}
+	File(HostFileData data, bool append): m_data(data), m_pos(append ? data->size() : 0) {}
+	operator bool() const {return (bool)m_data;}
+	void close() {m_data.reset();}
+	int available() {return (m_data) ? (int)(m_data->size() - m_pos) : 0;}
+	int read() {return (available() > 0) ? (uint8_t)(*m_data)[m_pos++] : -1;}
+	size_t read(uint8_t *buf, size_t n) {
+		if ((size_t)available() < n) n = available();
+		if (n) memcpy(buf, m_data->data() + m_pos, n);
+		m_pos += n;
+		return n;
+	}
+	size_t write(uint8_t c) {return write(&c, 1);}
+	size_t write(const uint8_t *buf, size_t n) {
+		if (!m_data) return 0;
+		m_data->replace(m_pos, n, (const char *)buf, n);
+		m_pos += n;
+		return n;
+	}
+	bool seek(uint32_t pos) {m_pos = (m_data && (pos <= m_data->size())) ? pos : m_pos; return m_pos == pos;}
+	size_t position() {return m_pos;}
+	size_t size() {return (m_data) ? m_data->size() : 0;}
+private:
+	HostFileData m_data;
+	size_t       m_pos;
+};
+
+class Dir {
+public:
+	Dir(): m_idx(-1) {}
+	Dir(const std::map<std::string, HostFileData> &files): m_idx(-1) {
+		for (auto &f : files) m_files.push_back(f);
+	}
+	bool next() {return ++m_idx < (int)m_files.size();}
+	String fileName() {return String(m_files[m_idx].first.substr(1));}
+	size_t fileSize() {return m_files[m_idx].second->size();}
+	File openFile(const char *mode) {return File(m_files[m_idx].second, false);}
+private:
+	std::vector<std::pair<std::string, HostFileData>> m_files;
+	int m_idx;
+};
+
+class FS {
+public:
+	bool begin() {return true;}
+	File open(const String &name, const char *mode) {
+		auto it = m_files.find(name);
+		if (mode[0] == 'w') {
+			m_files[name] = std::make_shared<std::string>();
+			return File(m_files[name], false);
+		}
+		if (it == m_files.end()) {
+			if (mode[0] != 'a') return File();
+			m_files[name] = std::make_shared<std::string>();
+			return File(m_files[name], true);
+		}
+		return File(it->second, mode[0] == 'a');
+	}
+	bool exists(const String &name) {return m_files.count(name) != 0;}
+	bool remove(const String &name) {return m_files.erase(name) != 0;}
+	bool rename(const String &from, const String &to) {
+		auto it = m_files.find(from);
+		if (it == m_files.end()) return false;
+		m_files[to] = it->second;
+		m_files.erase(from);
+		return true;
+	}
+	Dir openDir(const char *path) {return Dir(m_files);}
+public:
+	std::map<std::string, HostFileData> m_files;
+};
+extern FS LittleFS;
+
+#endif //__HOST_LITTLEFS_H__
@@ -0,0 +1,28 @@
+/*
+ * Host (PC) replacement of <eagle_soc.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_EAGLE_SOC_H__
+#define __HOST_EAGLE_SOC_H__
+
+#include "HostSim.h"
+
+/* Timer1 and GPIO registers are mapped to memory (see HostSim.cpp) */
+#define TIMER1_REGS_ADDR                  (host_timer1_regs)
+#define GPIO_REGS_ADDR                    (host_gpio_regs)
+#define FRC1_LOAD_ADDRESS                 (0)
+#define FRC1_INT_CLR_MASK                 (0x00000001)
+#define RTC_REG_WRITE(addr, val)          host_timer1_load(val)
+#define ETS_FRC_TIMER1_INTR_ATTACH(fn, a) host_timer1_attach(fn)
+#define TM1_EDGE_INT_ENABLE()
+#define ETS_FRC1_INTR_ENABLE()
+#define ETS_FRC1_INTR_DISABLE()
+#define ETS_GPIO_INTR_ENABLE()
+#define ETS_GPIO_INTR_DISABLE()
+
+#endif //__HOST_EAGLE_SOC_H__
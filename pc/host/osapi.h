@@ -0,0 +1,13 @@
+/*
+ * Host (PC) replacement of <osapi.h> for host builds of the firmware.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#ifndef __HOST_OSAPI_H__
+#define __HOST_OSAPI_H__
+
+#endif //__HOST_OSAPI_H__
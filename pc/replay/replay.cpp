@@ -0,0 +1,319 @@
+/*
+ * Record/replay regression harness.
+ * Replays a (timestamped) command stream into the host build of the firmware (command
+ * pipeline, motion queue, Motion1D ISR) and records STEP/DIR/EN edges and replies as a trace.
+ * The trace can be stored as a golden file and new runs compared with it (bit exact or
+ * within the given tolerance in clock cycles).
+ *
+ * build: g++ -O2 -std=gnu++17 -Ipc/host -Iinclude -Ilib/Planner/src -o pc/replay/replay \
+ *        pc/replay/replay.cpp pc/host/HostSim.cpp src/main.cpp src/Motion1D.cpp src/Command.cpp \
+ *        src/NetworkCommand.cpp src/HTTPCommand.cpp src/FileCommand.cpp src/TMC2208Uart.cpp lib/Planner/src/Planner.cpp lib/Planner/src/ramp.cpp
+ *
+ * usage: replay [-o trace] [-g golden [-u]] [-t tolerance] [-T max_s] [-f /p1.g=file] [-c] input
+ *        -c - compact trace (equally spaced edges of a pin are written as one series line),
+ *        pc/replay/run_tests.sh runs the stored regression cases (pc/replay/tests).
+ *
+ * Input lines:  [@time_ms] command   - command sent over TCP at the given time (default: right after the previous one),
+ *               [@time_ms] PIN,pin,level - drive input pin (endstop),
+ *               [@time_ms] TMC,reg,value - overwrite driver register (e.g. simulated driver reset),
+ *               [@time_ms] ENDSTOP,pin,position[,level] - endstop model, pin is at level (default 0 - switch, 1 - driver DIAG)
+ *                          while the position (in 1/256 microsteps) is at or below position,
+ *               [@time_ms] ENCODER,pin_a,pin_b,cpr - quadrature encoder model, cpr counts per motor revolution (200 full steps),
+ *               [@time_ms] BUSY,time_ms - main loop is blocked for time_ms (WiFi/network load, interrupts keep running),
+ *               [@time_ms] SLIP,distance - motor slips by distance in 1/256 microsteps (lost steps seen by the encoder only),
+ *               [@time_ms] DROP,n[,reg] - driver ignores the next n write datagrams (of register reg, noise on the bus),
+ *               # comment.
+ * Trace lines:  cycle P pin level    - output pin edge,
+ *               cycle S pin count interval - count more edges of the pin (levels alternate) from cycle on (-c),
+ *               cycle C command      - command received,
+ *               cycle R reply        - reply sent.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include <unistd.h>
+#include <vector>
+#include "Arduino.h"
+#include "Motion1D.h"
+#include "NetworkCommand.h"
+#include "FileCommand.h"
+
+#define LOOP_CYCLES (1600)                    /*!< Simulated main loop period (20us).       */
+
+extern Motion1D       *m1d;
+extern CommandDB       CmdDB;
+extern NetworkCommand *NCmd;
+extern FileCommand    *FCmd;
+void setup();
+void loop();
+
+typedef struct trace_event_s {
+	uint64_t    t;
+	char        kind;
+	std::string text;
+} trace_event_t;
+
+typedef struct input_line_s {
+	uint64_t    t;                            /*!< Time in clock cycles.                    */
+	std::string text;
+} input_line_t;
+
+static std::vector<trace_event_t> g_trace;
+static std::string                g_reply;
+static int                        g_end_pin = -1;   /*!< Endstop model pin (-1 - none).        */
+static int                        g_end_pos = 0;    /*!< Endstop switching position.            */
+static int                        g_end_lvl = 0;    /*!< Endstop active level.                  */
+static bool                       g_compact = false; /*!< Write edge series (-c).               */
+static int                        g_pin     = -1;   /*!< Pin of the last event (-1 - not an edge). */
+static uint64_t                   g_pin_t   = 0;    /*!< Time of the last edge.                 */
+static uint64_t                   g_pin_dt  = 0;    /*!< Interval of the last two edges.        */
+static uint64_t                   g_run_t   = 0;    /*!< First edge of the pending series.      */
+static int                        g_run_n   = 0;    /*!< Edges in the pending series.           */
+
+/*!
+ * \brief Write the pending edge series.
+ */
+static void traceFlush()
+{
+	if (g_run_n) g_trace.push_back({g_run_t, 'S', std::to_string(g_pin) + " " + std::to_string(g_run_n) + " " + std::to_string(g_pin_dt)});
+	g_run_n = 0;
+}
+//====================================================================================
+
+static void traceAdd(char kind, const std::string &text)
+{
+	traceFlush();
+	g_pin = -1;
+	g_trace.push_back({host_now, kind, text});
+}
+//====================================================================================
+
+/*!
+ * \brief Output pin edge, edges continuing at the same interval are collected into a series (-c).
+ */
+static void tracePin(int pin, int level)
+{
+	uint64_t dt = (pin == g_pin) ? host_now - g_pin_t : 0;
+
+	if ((g_compact) && (dt) && (dt == g_pin_dt)) {
+		if (g_run_n++ == 0) g_run_t = host_now;
+		g_pin_t = host_now;
+		return;
+	}
+	traceAdd('P', std::to_string(pin) + " " + std::to_string(level));
+	g_pin    = pin;
+	g_pin_t  = host_now;
+	g_pin_dt = dt;
+}
+//====================================================================================
+
+/*!
+ * \brief Collect replies, one trace event per line.
+ */
+static void onReply(const char *data, size_t len)
+{
+	for (size_t i = 0; i < len; ++i) {
+		if ((data[i] == '\r') || (data[i] == '\n')) {
+			if (g_reply.size()) traceAdd('R', g_reply);
+			g_reply.clear();
+		} else {
+			g_reply.push_back(data[i]);
+		}
+	}
+}
+//====================================================================================
+
+static int readInput(const char *name, std::vector<input_line_t> &in)
+{
+	char     line[256], *p, *e;
+	uint64_t t = 0;
+	FILE    *f = fopen(name, "r");
+
+	if (f == NULL) {
+		perror(name);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = 0;
+		for (p = line; (*p == ' ') || (*p == '\t'); ++p);
+		if ((*p == 0) || (*p == '#')) continue;
+		if (*p == '@') {
+			t = strtoull(p + 1, &e, 10) * (HOST_CLOCK / 1000);
+			for (p = e; (*p == ' ') || (*p == '\t'); ++p);
+		}
+		if (*p) in.push_back({t, p});
+	}
+	fclose(f);
+	return 0;
+}
+//====================================================================================
+
+static int loadFile(char *arg)
+{
+	char *eq = strchr(arg, '=');
+	FILE *f;
+	int   c;
+
+	if (eq == NULL) return -1;
+	*eq = 0;
+	if ((f = fopen(eq + 1, "rb")) == NULL) {
+		perror(eq + 1);
+		return -1;
+	}
+	File d = LittleFS.open(arg, "w");
+	while ((c = fgetc(f)) != EOF) d.write((uint8_t)c);
+	fclose(f);
+	return 0;
+}
+//====================================================================================
+
+static int writeTrace(const char *name)
+{
+	FILE *f = (strcmp(name, "-")) ? fopen(name, "w") : stdout;
+
+	if (f == NULL) {
+		perror(name);
+		return -1;
+	}
+	for (auto &e : g_trace) fprintf(f, "%llu %c %s\n", (unsigned long long)e.t, e.kind, e.text.c_str());
+	if (f != stdout) fclose(f);
+	return 0;
+}
+//====================================================================================
+
+/*!
+ * \brief Compare trace with golden file, return number of differences.
+ */
+static int compareTrace(const char *name, uint64_t tol)
+{
+	char               line[512], *e;
+	FILE              *f = fopen(name, "r");
+	size_t             i = 0;
+	int                err = 0;
+	unsigned long long t;
+	int64_t            d, dmax = 0;
+
+	if (f == NULL) {
+		perror(name);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = 0;
+		t = strtoull(line, &e, 10);
+		if (i >= g_trace.size()) {
+			if (err++ < 10) printf("missing: %s\n", line);
+			continue;
+		}
+		const trace_event_t &ev = g_trace[i++];
+		d = (int64_t)(ev.t - t);
+		if (d < 0) d = -d;
+		if (d > dmax) dmax = d;
+		if ((e[0] != ' ') || (e[1] != ev.kind) || (ev.text != (e + 3)) || ((uint64_t)d > tol)) {
+			if (err++ < 10) printf("golden: %s\nreplay: %llu %c %s\n", line, (unsigned long long)ev.t, ev.kind, ev.text.c_str());
+		}
+	}
+	fclose(f);
+	for (; i < g_trace.size(); ++i) {
+		if (err++ < 10) printf("extra: %llu %c %s\n", (unsigned long long)g_trace[i].t, g_trace[i].kind, g_trace[i].text.c_str());
+	}
+	printf("%s: %zu events, %d differences, max time difference %lld cycles\n", name, g_trace.size(), err, (long long)dmax);
+	return err;
+}
+//====================================================================================
+
+int main(int argc, char **argv)
+{
+	std::vector<input_line_t> in;
+	const char *out = NULL, *golden = NULL;
+	uint64_t    tol = 0, tmax = 600 * HOST_CLOCK;
+	int         opt, update = 0, pin, level, pinB, cpr, args;
+	unsigned    reg, value;
+	size_t      next = 0;
+	AsyncClient client;
+
+	while ((opt = getopt(argc, argv, "o:g:ut:T:f:c")) != -1) {
+		switch (opt) {
+			case 'o': out = optarg; break;
+			case 'g': golden = optarg; break;
+			case 'u': update = 1; break;
+			case 't': tol = strtoull(optarg, NULL, 10); break;
+			case 'T': tmax = strtoull(optarg, NULL, 10) * HOST_CLOCK; break;
+			case 'f': if (loadFile(optarg) < 0) return 1; break;
+			case 'c': g_compact = true; break;
+			default:
+				fprintf(stderr, "usage: %s [-o trace] [-g golden [-u]] [-t tolerance] [-T max_s] [-f /p1.g=file] [-c] input\n", argv[0]);
+				return 1;
+		}
+	}
+	if ((optind >= argc) || (readInput(argv[optind], in) < 0)) {
+		fprintf(stderr, "usage: %s [-o trace] [-g golden [-u]] [-t tolerance] [-T max_s] [-f /p1.g=file] [-c] input\n", argv[0]);
+		return 1;
+	}
+	host_on_pin([](uint64_t t, int pin, int level) {
+		tracePin(pin, level);
+		/* Endstop follows the position (edge right after the STEP pulse) */
+		if ((g_end_pin >= 0) && (pin == HOST_TMC_STEP) && (level)) host_pin_input(g_end_pin, (x_pos <= g_end_pos) ? g_end_lvl : !g_end_lvl);
+	});
+	setup();
+	client.onHostData = onReply;
+	NCmd->m_client    = &client;
+
+	/* Run until the last command is processed and the slider stands still */
+	while (host_now < tmax) {
+		while ((next < in.size()) && (in[next].t <= host_now)) {
+			const std::string &cmd = in[next++].text;
+			if (sscanf(cmd.c_str(), "PIN,%d,%d", &pin, &level) == 2) {
+				host_pin_input(pin, level);
+				continue;
+			}
+			if (sscanf(cmd.c_str(), "ENDSTOP,%d,%d,%d", &g_end_pin, &g_end_pos, &g_end_lvl) >= 2) {
+				host_pin_input(g_end_pin, (x_pos <= g_end_pos) ? g_end_lvl : !g_end_lvl);
+				continue;
+			}
+			if (sscanf(cmd.c_str(), "ENCODER,%d,%d,%d", &pin, &pinB, &cpr) == 3) {
+				host_encoder_attach(pin, pinB, 200 * MICROSTEP_FINE, cpr);
+				continue;
+			}
+			if (sscanf(cmd.c_str(), "BUSY,%d", &level) == 1) {
+				host_run((uint64_t)level * (HOST_CLOCK / 1000));
+				continue;
+			}
+			if (sscanf(cmd.c_str(), "SLIP,%d", &level) == 1) {
+				host_tmc_slip(level);
+				continue;
+			}
+			if ((args = sscanf(cmd.c_str(), "DROP,%d,%i", &level, &reg)) >= 1) {
+				host_tmc_drop_writes(level, (args == 2) ? (int)reg : -1);
+				continue;
+			}
+			if ((sscanf(cmd.c_str(), "TMC,%i,%i", &reg, &value) == 2) && (reg < 128)) {
+				host_tmc_regs[reg] = value;
+				continue;
+			}
+			std::string line = cmd + "\r";
+			traceAdd('C', cmd);
+			NCmd->handleData((char *)line.c_str(), line.length());
+		}
+		loop();
+		host_run(LOOP_CYCLES);
+		if ((next >= in.size()) && (!m1d->isInMotion()) && (CmdDB.m_commandQueue.empty()) && \
+			(CmdDB.m_motionQueue.empty()) && (!FCmd->isPlaying())) break;
+	}
+	if (host_now >= tmax) fprintf(stderr, "time limit reached\n");
+	traceFlush();
+
+	if (out) writeTrace(out);
+	if (golden) {
+		if ((update) || (access(golden, F_OK) != 0)) {
+			printf("%s: golden trace written (%zu events)\n", golden, g_trace.size());
+			return (writeTrace(golden) < 0) ? 1 : 0;
+		}
+		return (compareTrace(golden, tol) != 0) ? 1 : 0;
+	}
+	if (out == NULL) writeTrace("-");
+	return 0;
+}
+//====================================================================================
@@ -0,0 +1,66 @@
+#!/bin/sh
+#
+# Replay regression cases - the host build of the firmware is compared with the golden traces
+# (pc/replay/tests/*.golden, compact traces, bit exact).
+#
+# usage: pc/replay/run_tests.sh [-u]   (run from the repository root, -u - write new golden traces)
+#
+# Author: Rafal Vonau <rafal.vonau@gmail.com>
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 3 as
+# published by the Free Software Foundation.
+#
+SRC="pc/replay/replay.cpp pc/host/HostSim.cpp src/main.cpp src/Motion1D.cpp src/Command.cpp src/NetworkCommand.cpp src/HTTPCommand.cpp src/FileCommand.cpp src/TMC2208Uart.cpp lib/Planner/src/Planner.cpp lib/Planner/src/ramp.cpp"
+FLAGS="-O2 -std=gnu++17 -Ipc/host -Iinclude -Ilib/Planner/src"
+T=pc/replay/tests
+UPDATE=""
+FAILED=0
+
+[ "$1" = "-u" ] && UPDATE="-u"
+g++ $FLAGS -o pc/replay/replay $SRC || exit 1
+g++ $FLAGS -DDRIVER_TMC2209 -o pc/replay/replay_2209 $SRC || exit 1
+
+# run binary name [replay options] input
+run() {
+	BIN=$1
+	NAME=$2
+	shift 2
+	pc/replay/$BIN -c $UPDATE -g $T/$NAME.golden "$@" || { echo "FAILED: $NAME"; FAILED=1; }
+}
+
+# Stored programs
+run replay test_fast_10 pc/test_fast_10.gcode
+run replay test_fast_20 pc/test_fast_20.gcode
+run replay test_fast_30 pc/test_fast_30.gcode
+run replay test_fast_40 pc/test_fast_40.gcode
+run replay tymek -T 50 pc/tymek.gcode
+# Resolution switching
+run replay resolution $T/resolution.rec
+run replay resolution_auto $T/resolution_auto.rec
+run replay resolution_map $T/resolution_map.rec
+run replay resolution_stop $T/resolution_stop.rec
+run replay units $T/units.rec
+run replay lost_steps $T/lost_steps.rec
+# Hybrid cruise
+run replay hybrid $T/hybrid.rec
+run replay hybrid_drop $T/hybrid_drop.rec
+run replay hybrid_stall $T/hybrid_stall.rec
+run replay hybrid_busy $T/hybrid_busy.rec
+# Homing
+run replay home $T/home.rec
+run replay home_cancel $T/home_cancel.rec
+run replay_2209 home_stall_2209 $T/home_stall_2209.rec
+# Encoder
+run replay encoder $T/encoder.rec
+run replay encoder_hybrid $T/encoder_hybrid.rec
+# Motion queue
+run replay loop_range $T/loop_range.rec
+run replay curve_late $T/curve_late.rec
+run replay dwell $T/dwell.rec
+run replay speed_map_empty $T/speed_map_empty.rec
+run replay speed_map_units $T/speed_map_units.rec
+run replay step_rate $T/step_rate.rec
+
+[ $FAILED = 0 ] && echo "All replay cases passed"
+exit $FAILED
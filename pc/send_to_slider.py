@@ -10,6 +10,7 @@ from datetime import datetime
 parser = argparse.ArgumentParser(description='Process some arguments.')
 parser.add_argument('-l', '--local', action='store_true')
 parser.add_argument('-i','--input' ,help='input file')
+parser.add_argument('-r','--record' ,help='record timestamped command stream (for pc/replay)')
 args = parser.parse_args()
 
 def readline(s):
@@ -29,6 +30,8 @@ def writeline(s, v):
 def sendCommand(s, x):
 	if (x != ""):
 		print('Send: '+x)
+		if record:
+			record.write('@%d %s\n' % (int((time.time() - record_start) * 1000), x.strip()))
 		try :
 			writeline(s, x + "\r")
 		except socket.error:
@@ -47,6 +50,11 @@ if args.local:
 
 if args.input:
 	inputfile = args.input
+
+record = None
+record_start = time.time()
+if args.record:
+	record = open(args.record, 'w')
   
 print("Host: "+host);
 
@@ -99,4 +107,6 @@ sendCommand(s,"XX\r")
 s.close()
 time.sleep(1.0)
 file1.close()
+if record:
+	record.close()
 
@@ -0,0 +1,266 @@
+/*
+ * Compile slider text program (gcode) into compact binary motion segments.
+ * Moves are planned on the host with the firmware planner (lib/Planner), the slider
+ * streams the segments directly into the motion queue.
+ *
+ * build: g++ -O2 -Iinclude -Ilib/Planner/src -o pc/slider_compile pc/slider_compile.cpp lib/Planner/src/Planner.cpp lib/Planner/src/ramp.cpp
+ * usage: slider_compile [-s start] [-u microsteps] [-m max_rev] input.gcode output.b
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+#include "MotionSegment.h"
+#include "Planner.h"
+
+#define MAX_ARGS (3)
+
+/* Custom curve control ordinates (in [1/1000]) */
+static int g_curve_custom[2] = {0, 1000};
+
+static std::vector<motion_segment_t> g_seg;
+static motion_program_hdr_t          g_hdr;
+static int g_pos_x   = 0;
+static int g_max_rev = 45;
+static int g_line    = 0;
+
+static void addSegment(int type, int steps, uint32_t value, uint32_t arg = 0, int flags = 0)
+{
+	motion_segment_t s;
+
+	memset(&s, 0, sizeof(s));
+	s.type  = type;
+	s.flags = flags;
+	s.steps = steps;
+	s.value = value;
+	s.arg   = arg;
+	g_seg.push_back(s);
+}
+//====================================================================================
+
+/*!
+ * \brief Move to absolute position (clamped to the slider length).
+ */
+static void moveTo(int duration, int newS, int flags = 0)
+{
+	int mm = g_max_rev * 200 * g_hdr.microsteps;
+
+	if (!(flags & SEGMENT_NO_LIMIT)) newS = planner_clamp(newS, mm);
+	if (newS != g_pos_x) addSegment(MOTION_CMD_MOVE, newS - g_pos_x, planner_duration_hperiod(duration, newS - g_pos_x), 0, flags);
+	g_pos_x = newS;
+}
+//====================================================================================
+
+static int fail(const char *text)
+{
+	fprintf(stderr, "line %d: %s\n", g_line, text);
+	return -1;
+}
+//====================================================================================
+
+/*!
+ * \brief Compile one command line, return -1 on error.
+ */
+static int compileLine(char *line)
+{
+	int   arg[MAX_ARGS], mask = 0, n = 0, curve;
+	char *cmd = strtok(line, ",");
+	char *a;
+
+	while ((n < MAX_ARGS) && ((a = strtok(NULL, ",")) != NULL)) {
+		arg[n] = atoi(a);
+		mask  |= 1 << n;
+		n++;
+	}
+	/* Program settings - only before the first segment */
+	if ((!strcmp(cmd, "G90")) || (!strcmp(cmd, "S")) || (!strcmp(cmd, "C"))) {
+		if (g_seg.size()) return fail("settings (G90/S/C) allowed only before the first move");
+		if (!strcmp(cmd, "G90")) {
+			g_hdr.flags |= SEGMENT_FILE_ZERO;
+			g_hdr.start  = 0;
+			g_pos_x      = 0;
+		} else if (!(mask & 1)) {
+			return fail("missing argument");
+		} else if (!strcmp(cmd, "S")) {
+			g_hdr.microsteps = arg[0];
+		} else {
+			g_hdr.current = arg[0];
+		}
+		return 0;
+	}
+	if (!strcmp(cmd, "EM")) {
+		fprintf(stderr, "line %d: EM skipped (motors are enabled by the first move)\n", g_line);
+		return 0;
+	}
+	if ((!strcmp(cmd, "M")) || (!strcmp(cmd, "GT"))) {
+		int scale = (cmd[0] == 'M') ? (200 * g_hdr.microsteps) : 1;
+		int speed = (cmd[0] == 'M') ? 6000 : 3000;
+		int s;
+
+		if ((mask & 7) != 7) return fail("missing argument");
+		if (cmd[0] == 'M') {
+			/* Revolutions are clamped before conversion */
+			arg[1] = planner_clamp(arg[1], g_max_rev);
+			arg[2] = planner_clamp(arg[2], g_max_rev);
+		}
+		s = planner_clamp(arg[1] * scale, g_max_rev * 200 * g_hdr.microsteps);
+		moveTo(planner_speed_duration(s - g_pos_x, speed), s);
+		moveTo(arg[0], arg[2] * scale);
+		return 0;
+	}
+	if ((!strcmp(cmd, "MR")) || (!strcmp(cmd, "GTR")) || (!strcmp(cmd, "UM"))) {
+		if ((mask & 3) != 3) return fail("missing argument");
+		if (cmd[0] == 'M') arg[1] *= 200 * g_hdr.microsteps;
+		moveTo(arg[0], g_pos_x + arg[1], (cmd[0] == 'U') ? SEGMENT_NO_LIMIT : 0);
+		return 0;
+	}
+	if (!strcmp(cmd, "BZ")) {
+		int mm = g_max_rev * 200 * g_hdr.microsteps, newS;
+		const int *p;
+
+		if ((mask & 3) != 3) return fail("missing argument");
+		curve = (mask & 4) ? arg[2] : CURVE_EASE_IN_OUT;
+		if ((curve < CURVE_LINEAR) || (curve > CURVE_CUSTOM)) return fail("invalid curve");
+		p    = (curve == CURVE_CUSTOM) ? g_curve_custom : planner_curve_p[curve];
+		newS = planner_clamp(g_pos_x + arg[1], mm);
+		if (newS != g_pos_x) addSegment(MOTION_CMD_CURVE, newS - g_pos_x, arg[0], (p[0] << 16) | p[1]);
+		g_pos_x = newS;
+		return 0;
+	}
+	if (!strcmp(cmd, "BZC")) {
+		if (((mask & 3) != 3) || (arg[0] < 0) || (arg[0] > 1000) || (arg[1] < 0) || (arg[1] > 1000)) return fail("invalid curve");
+		g_curve_custom[0] = arg[0];
+		g_curve_custom[1] = arg[1];
+		return 0;
+	}
+	if (!strcmp(cmd, "DW")) {
+		if ((!(mask & 1)) || (arg[0] < 0)) return fail("invalid dwell");
+		addSegment(MOTION_CMD_DWELL, 0, arg[0]);
+		return 0;
+	}
+	if (!strcmp(cmd, "LB")) {
+		/* Loop position bookkeeping is done by the slider */
+		addSegment(MOTION_CMD_LOOP, 0, (mask & 1) ? arg[0] : 0);
+		return 0;
+	}
+	if (!strcmp(cmd, "LE")) {
+		addSegment(MOTION_CMD_ENDL, 0, 0);
+		return 0;
+	}
+	return fail("command not supported in binary programs");
+}
+//====================================================================================
+
+/*!
+ * \brief Track the planned position through loops (the slider applies the same rules).
+ * The whole loop body excursion is checked for the first and the last iteration.
+ */
+static int checkLoops()
+{
+	int64_t pos[64], lo[64], hi[64], l, h, net, x = g_hdr.start, mm = (int64_t)g_max_rev * 200 * g_hdr.microsteps;
+	int     count[64], n = 0, last;
+
+	for (size_t i = 0; i < g_seg.size(); ++i) {
+		const motion_segment_t *s = &g_seg[i];
+		if (s->type == MOTION_CMD_LOOP) {
+			if (n == 4) {fprintf(stderr, "segment %zu: loops nested too deep\n", i); return -1;}
+			pos[n] = lo[n] = hi[n] = x; count[n] = s->value; n++;
+		} else if (s->type == MOTION_CMD_ENDL) {
+			if (n == 0) {fprintf(stderr, "segment %zu: LE without LB\n", i); return -1;}
+			n--;
+			net = x - pos[n];
+			if ((count[n] == 0) && (net)) {fprintf(stderr, "segment %zu: endless loop must return to start position\n", i); return -1;}
+			last = (count[n]) ? count[n] - 1 : 0;
+			l    = lo[n] + ((net < 0) ? net * last : 0);
+			h    = hi[n] + ((net > 0) ? net * last : 0);
+			if ((l < 0) || (h > mm)) {fprintf(stderr, "segment %zu: loop out of range\n", i); return -1;}
+			for (int j = 0; j < n; ++j) {
+				if (l < lo[j]) lo[j] = l;
+				if (h > hi[j]) hi[j] = h;
+			}
+			x += net * last;
+		} else {
+			x += s->steps;
+			if (s->flags & SEGMENT_NO_LIMIT) continue;
+			for (int j = 0; j < n; ++j) {
+				if (x < lo[j]) lo[j] = x;
+				if (x > hi[j]) hi[j] = x;
+			}
+		}
+	}
+	if (n) fprintf(stderr, "warning: %d loop(s) not closed\n", n);
+	return 0;
+}
+//====================================================================================
+
+int main(int argc, char **argv)
+{
+	char     line[256], *p;
+	int      opt;
+	uint64_t t = 0;
+	FILE    *in, *out;
+
+	memset(&g_hdr, 0, sizeof(g_hdr));
+	g_hdr.magic      = SEGMENT_MAGIC;
+	g_hdr.version    = SEGMENT_VERSION;
+	g_hdr.microsteps = 16;
+	while ((opt = getopt(argc, argv, "s:u:m:")) != -1) {
+		switch (opt) {
+			case 's': g_hdr.start = atoi(optarg); break;
+			case 'u': g_hdr.microsteps = atoi(optarg); break;
+			case 'm': g_max_rev = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage: %s [-s start] [-u microsteps] [-m max_rev] input.gcode output.b\n", argv[0]);
+				return 1;
+		}
+	}
+	if (argc - optind != 2) {
+		fprintf(stderr, "usage: %s [-s start] [-u microsteps] [-m max_rev] input.gcode output.b\n", argv[0]);
+		return 1;
+	}
+	if ((in = fopen(argv[optind], "r")) == NULL) {
+		perror(argv[optind]);
+		return 1;
+	}
+	g_pos_x = g_hdr.start;
+	while (fgets(line, sizeof(line), in)) {
+		g_line++;
+		/* Strip line end and skip comments */
+		line[strcspn(line, "\r\n;#")] = 0;
+		for (p = line; (*p == ' ') || (*p == '\t'); ++p);
+		if (*p == 0) continue;
+		if (compileLine(p) < 0) {
+			fclose(in);
+			return 1;
+		}
+	}
+	fclose(in);
+	if (checkLoops() < 0) return 1;
+	g_hdr.count = g_seg.size();
+	if ((out = fopen(argv[optind + 1], "wb")) == NULL) {
+		perror(argv[optind + 1]);
+		return 1;
+	}
+	fwrite(&g_hdr, sizeof(g_hdr), 1, out);
+	if (g_seg.size()) fwrite(g_seg.data(), sizeof(motion_segment_t), g_seg.size(), out);
+	fclose(out);
+	/* Predicted time of one pass (loops are not repeated), ramp included */
+	for (size_t i = 0; i < g_seg.size(); ++i) {
+		if (g_seg[i].type == MOTION_CMD_MOVE) {
+			t += planner_move_cycles(g_seg[i].steps, g_seg[i].value) / (PLANNER_CLOCK / 1000);
+		} else if ((g_seg[i].type == MOTION_CMD_CURVE) || (g_seg[i].type == MOTION_CMD_DWELL)) {
+			t += g_seg[i].value;
+		}
+	}
+	printf("%s: %u segments, %zu bytes, one pass %llu ms\n", argv[optind + 1], g_hdr.count, sizeof(g_hdr) + g_seg.size() * sizeof(motion_segment_t), (unsigned long long)t);
+	return 0;
+}
+//====================================================================================
@@ -2,5 +2,9 @@ G90
 EM,1,1
 C,400
 S,16
-SM,20000,128000
-SM,20000,-128000
\ No newline at end of file
+LB,0
+GTR,20000,128000
+DW,1000
+GTR,20000,-128000
+DW,1000
+LE
\ No newline at end of file
@@ -0,0 +1,45 @@
+#!/usr/bin/env python2
+
+#
+# Upload program to the slider flash (LittleFS).
+# Program is stored only when CRC32 calculated by the slider matches.
+#
+# usage: upload_program.py -p 1 -i tymek.gcode
+#        upload_program.py -p 1 -i tymek.b   (compiled by slider_compile)
+#
+
+import sys
+import zlib
+import argparse
+try:
+	import httplib
+except ImportError:
+	import http.client as httplib
+
+
+parser = argparse.ArgumentParser(description='Upload program to the slider.')
+parser.add_argument('-l', '--local', action='store_true')
+parser.add_argument('-p', '--prog', type=int, default=1, help='program number (0 - autorun)')
+parser.add_argument('-i', '--input', required=True, help='input file')
+args = parser.parse_args()
+
+host = 'slider.local'
+if args.local:
+	host = "127.0.0.1"
+
+data = open(args.input, 'rb').read()
+# Binary (compiled) programs start with "SLB1"
+ext = '.b' if data[:4] == b'SLB1' else '.g'
+crc = zlib.crc32(data) & 0xffffffff
+boundary = '----SliderProgramUpload'
+body = ('--' + boundary + '\r\n' + \
+	'Content-Disposition: form-data; name="file"; filename="p' + str(args.prog) + ext + '"\r\n' + \
+	'Content-Type: application/octet-stream\r\n\r\n').encode('ascii') + data + \
+	('\r\n--' + boundary + '--\r\n').encode('ascii')
+
+print('Host: ' + host + ' program: ' + str(args.prog) + ' size: ' + str(len(data)) + ' crc: %08x' % crc)
+c = httplib.HTTPConnection(host, 80)
+c.request('POST', '/upload?prog=%d&crc=%08x' % (args.prog, crc), body, {'Content-Type': 'multipart/form-data; boundary=' + boundary})
+r = c.getresponse()
+print(str(r.status) + ' ' + r.read().decode('ascii'))
+sys.exit(0 if r.status == 200 else 1)
@@ -0,0 +1,158 @@
+/*
+ * FileCommand - Execute programs stored in the LittleFS filesystem.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include "FileCommand.h"
+
+/*!
+ * \brief CRC32 (IEEE 802.3, same as zlib) - continue calculation from crc (0 - start).
+ */
+uint32_t FileCommand::crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+	int k;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *data++;
+		for (k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+	return ~crc;
+}
+//====================================================================================
+
+/*!
+ * \brief Calculate CRC32 of the whole file.
+ */
+uint32_t FileCommand::fileCrc32(File &f)
+{
+	uint8_t  buf[64];
+	uint32_t crc = 0;
+	size_t   n;
+
+	f.seek(0);
+	while ((n = f.read(buf, sizeof(buf))) > 0) {
+		crc = crc32(crc, buf, n);
+	}
+	return crc;
+}
+//====================================================================================
+
+/*!
+ * \brief Start program (binary program is used when both exist).
+ */
+int FileCommand::play(int prog, Command *owner)
+{
+	motion_program_hdr_t h;
+
+	stopPlay();
+	m_binary   = false;
+	m_segValid = false;
+	m_segNo    = 0;
+	if (LittleFS.exists(programName(prog, true))) {
+		m_file = LittleFS.open(programName(prog, true), "r");
+		if (!m_file) return FILE_PLAY_NO_FILE;
+		if ((m_file.read((uint8_t *)&h, sizeof(h)) != sizeof(h)) || (h.magic != SEGMENT_MAGIC) || \
+			(h.version != SEGMENT_VERSION) || (!m_segmentCb) || (m_headerCb(&h) < 0)) {
+			m_file.close();
+			return FILE_PLAY_INVALID;
+		}
+		m_binary = true;
+	} else {
+		m_file = LittleFS.open(programName(prog), "r");
+		if (!m_file) return FILE_PLAY_NO_FILE;
+	}
+	m_prog  = prog;
+	m_owner = owner;
+	clearBuffer();
+	return FILE_PLAY_OK;
+}
+//====================================================================================
+
+/*!
+ * \brief Stop program (already queued moves are not affected).
+ */
+void FileCommand::stopPlay()
+{
+	if (m_prog >= 0) {
+		m_file.close();
+		m_prog = -1;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Print list of programs (name, size, CRC32).
+ */
+void FileCommand::list(CommandQueueItem *c)
+{
+	Dir    dir = LittleFS.openDir("/");
+	String s;
+
+	while (dir.next()) {
+		File f = dir.openFile("r");
+		s += dir.fileName() + "," + String(dir.fileSize()) + "," + String(fileCrc32(f), HEX) + "\r\n";
+		f.close();
+	}
+	c->print(s + "OK\r\n");
+}
+//====================================================================================
+
+/*!
+ * \brief Stream program lines into the command queues (only a few motion commands ahead),
+ * binary segments are pushed directly to the motion queue.
+ */
+void FileCommand::loop()
+{
+	int inChar, r;
+
+	/* Binary program - segments go directly to the motion queue */
+	while ((m_prog >= 0) && (m_binary)) {
+		if (!m_segValid) {
+			if (m_file.read((uint8_t *)&m_seg, sizeof(m_seg)) != sizeof(m_seg)) {
+				stopPlay();
+				return;
+			}
+			m_segValid = true;
+		}
+		r = m_segmentCb(&m_seg);
+		if (r == 0) return;
+		if (r < 0) {
+			print("!8 Err: Invalid segment " + String(m_segNo) + "\r\n");
+			stopPlay();
+			return;
+		}
+		m_segValid = false;
+		m_segNo++;
+	}
+
+	while ((m_prog >= 0) && (m_db->m_motionQueue.size() < FILE_PREFETCH)) {
+		inChar = m_file.read();
+		if (inChar < 0) {
+			/* End of program */
+			if (bufPos) {
+				buffer[bufPos] = '\0';
+				m_db->executeCommand(this, buffer);
+				clearBuffer();
+			}
+			stopPlay();
+			return;
+		}
+		if ((inChar == '\r') || (inChar == '\n')) {
+			if (bufPos) {
+				buffer[bufPos] = '\0';
+				m_db->executeCommand(this, buffer);
+				clearBuffer();
+			}
+		} else if (isprint(inChar)) {     // Only printable characters into the buffer
+			if (bufPos < COMMAND_BUFFER) {
+				buffer[bufPos++] = inChar;  // Put character into buffer
+			}
+		}
+	}
+}
+//====================================================================================
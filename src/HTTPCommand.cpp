@@ -8,8 +8,11 @@
  * published by the Free Software Foundation.
  */
 #include "HTTPCommand.h"
+#include "FileCommand.h"
 #include "www_fs.h"
 
+#define UPLOAD_TMP "/upload.tmp"
+
 //====================================================================================
 //=============================-- NETWORK EVENTS--====================================
 //====================================================================================
@@ -32,6 +35,9 @@ HTTPCommand::HTTPCommand(CommandDB *db): Command(db)
 {
 	m_server = new AsyncWebServer(80);
 	m_events = new AsyncEventSource("/events");
+	m_uploadCrc = 0;
+	m_uploadOk  = false;
+	m_uploadBinary = false;
 
 	m_server->on("/", HTTP_GET, [](AsyncWebServerRequest *request){handle_request(request, "text/html", __index_html, www_index_html_size);});
 	/* Java Script */
@@ -58,6 +64,16 @@ HTTPCommand::HTTPCommand(CommandDB *db): Command(db)
 		}
 		request->send(200, "text/plain", message);
 	});
+	/* Program upload (POST /upload?prog=n&crc=crc32_hex, multipart file) */
+	m_server->on("/upload", HTTP_POST, [this](AsyncWebServerRequest *request) {
+		if (m_uploadOk) {
+			request->send(200, "text/plain", "OK");
+		} else {
+			request->send(400, "text/plain", "Upload failed (CRC error)");
+		}
+	}, [this](AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final) {
+		handleUpload(request, index, data, len, final);
+	});
 	m_server->onNotFound(notFound);
 
 	m_events->onConnect([](AsyncEventSourceClient *client) {client->send("hello!",NULL,millis(),1000);});
@@ -93,3 +109,35 @@ void HTTPCommand::handleData(const char *data, int n)
 	}
 }
 //====================================================================================
+
+/*!
+ * \brief Store uploaded program - written to temporary file and renamed when CRC32 matches.
+ * Binary programs (starting with SEGMENT_MAGIC) are stored as /p<n>.b, text programs as /p<n>.g.
+ */
+void HTTPCommand::handleUpload(AsyncWebServerRequest *request, size_t index, uint8_t *data, size_t len, bool final)
+{
+	if (index == 0) {
+		m_uploadOk  = false;
+		m_uploadCrc = 0;
+		if (m_uploadFile) m_uploadFile.close();
+		if ((!request->hasParam("prog")) || (!request->hasParam("crc"))) return;
+		m_uploadBinary = ((len >= 4) && (data[0] == (SEGMENT_MAGIC & 0xff)) && (data[1] == ((SEGMENT_MAGIC >> 8) & 0xff)) && \
+			(data[2] == ((SEGMENT_MAGIC >> 16) & 0xff)) && (data[3] == ((SEGMENT_MAGIC >> 24) & 0xff)));
+		m_uploadFile = LittleFS.open(UPLOAD_TMP, "w");
+	}
+	if (!m_uploadFile) return;
+	m_uploadFile.write(data, len);
+	m_uploadCrc = FileCommand::crc32(m_uploadCrc, data, len);
+	if (final) {
+		m_uploadFile.close();
+		if (m_uploadCrc == strtoul(request->getParam("crc")->value().c_str(), NULL, 16)) {
+			int prog = request->getParam("prog")->value().toInt();
+			LittleFS.remove(FileCommand::programName(prog, false));
+			LittleFS.remove(FileCommand::programName(prog, true));
+			m_uploadOk = LittleFS.rename(UPLOAD_TMP, FileCommand::programName(prog, m_uploadBinary));
+		} else {
+			LittleFS.remove(UPLOAD_TMP);
+		}
+	}
+}
+//====================================================================================
@@ -14,14 +14,13 @@ extern "C" {
 #include "Motion1D.h"
 #include "esp8266_gpio_direct.h"
 #include "core_esp8266_waveform.h"
-#include "ramp.h"
+#include "Planner.h"
 
 #define TIMER1_DIVIDE_BY_1              0x0000
 #define TIMER1_DIVIDE_BY_16             0x0004
 #define TIMER1_ENABLE_TIMER             0x0080
 #define TIMER1_AUTORELOAD               (1u<<6)
-
-#define MIN_PERIOD                      (4000)
+#define CCOUNT_PER_CLOCK                (F_CPU / 80000000L)   /*!< CPU cycles per timer1 clock cycle. */
 
 static volatile int        int_active       = 0;   /*!< Timer1 interrupt is active (Timer1 is running).   */
 static volatile int        in_motion        = 0;   /*!< We are in motion.                                 */
@@ -29,19 +28,56 @@ static volatile int        in_motion        = 0;   /*!< We are in motion.
 /* X */
 static uint16_t            x_gpio_mask      = 0;   /*!< GPIO mask for STEP pin.                           */
 static volatile uint32_t   x_hperiod        = 0;   /*!< TIMER1 half period in clock cycles (80MHz clock). */
-volatile int               x_target         = 0;   /*!< Target position.                                  */
-volatile int               x_pos            = 0;   /*!< Current position.                                 */
+volatile int               x_target         = 0;   /*!< Target position (in 1/256 microsteps).            */
+volatile int               x_pos            = 0;   /*!< Current position (in 1/256 microsteps).           */
+static volatile int        x_shift          = 0;   /*!< Driver resolution (1/256 microsteps per STEP).    */
 static volatile int        x_pulse          = 0;   /*!< STEP pulse phase 0 (level 0), 1 (level 1).        */
+static volatile int        x_dwell          = 0;   /*!< Dwell timer ticks left.                           */
+
+/* Endstop (GPIO interrupt) */
+static volatile int        x_end_armed      = 0;   /*!< Next endstop edge latches the position.           */
+static volatile int        x_end_hit        = 0;   /*!< Endstop triggered since it was armed.             */
+static volatile int        x_end_pos        = 0;   /*!< Position at the endstop edge.                     */
+static volatile int        x_end_cut        = 0;   /*!< Running move was shortened by the endstop.        */
+static volatile int        x_end_hard       = 0;   /*!< Endstop is a hard stop - no deceleration past it. */
+static volatile int        x_stall_enabled  = 0;   /*!< Unarmed endstop edge stops the motion (stall).    */
+static volatile int        x_stall_hit      = 0;   /*!< Stall detected.                                   */
+static volatile int        x_stall_pos      = 0;   /*!< Position at the stall.                            */
+
+/* Quadrature encoder */
+static int                 x_enc_a          = -1;  /*!< Encoder A pin.                                    */
+static int                 x_enc_b          = -1;  /*!< Encoder B pin.                                    */
+static volatile int        x_enc_state      = 0;   /*!< Last A/B levels (A - bit 1).                      */
+static volatile int        x_enc_count      = 0;   /*!< Encoder counts (x4 decoding).                     */
+static volatile uint32_t   x_enc_invalid    = 0;   /*!< Invalid transitions (both channels changed).      */
+/* Count change for (previous A/B << 2) | A/B, forward: 00 -> 01 -> 11 -> 10 -> 00 */
+static const int8_t        enc_table[16]    = {0, 1, -1, ENC_INVALID, -1, 0, ENC_INVALID, 1, 1, ENC_INVALID, 0, -1, ENC_INVALID, -1, 1, 0};
+
+/* Step rate self-test (ISR timing in CPU cycles) */
+static volatile int        x_test_active    = 0;   /*!< ISR timing is recorded.                           */
+static volatile uint32_t   x_test_last      = 0;   /*!< Previous ISR entry (0 - none).                    */
+static volatile uint32_t   x_test_late      = 0;   /*!< Late ISR entries (missed timer edges).            */
+static volatile uint32_t   x_test_dmax      = 0;   /*!< Maximum interval between ISR entries.             */
+static volatile uint32_t   x_test_isr_max   = 0;   /*!< Maximum ISR duration.                             */
 
 #ifdef USE_RAMP
-volatile int               x_pos_start      = 0;   /*!< Motion start position.                            */
-volatile int               x_pos_middle     = 0;   /*!< Motion middle point.                              */
-volatile int               x_ramp_len       = 0;   /*!< Motion ramp length.                               */
-volatile int               x_ramp_pos       = 0;   /*!< Current ramp table index.                         */
-volatile int               x_ramp_iter      = 0;   /*!< Current iterations.                               */
-volatile int               x_ramp_phase     = 0;   /*!< Current ramp phase.                               */
-volatile uint32_t          x_target_hperiod = 0;   /*!< Target half period.                               */
-volatile int               x_dir            = 0;   /*!< Motion direction.                                 */
+static volatile uint32_t   x_target_hperiod = 0;   /*!< Target (cruise) half period.                      */
+static volatile int        x_ramp_iter      = 0;   /*!< Steps left on the current ramp level.             */
+static volatile int        x_brake          = 0;   /*!< Steps needed to decelerate to start/stop speed.   */
+static volatile int        x_ramp_enabled   = 1;   /*!< Ramp is used (disabled for curve segments).       */
+
+/* Position-indexed speed map (knots sorted by position) */
+static int                 map_n            = 0;   /*!< Number of knots.                                  */
+static int                 map_pos[SPEED_MAP_SIZE];/*!< Knot position.                                    */
+static int                 map_v[SPEED_MAP_SIZE];  /*!< Knot speed in [1/256 microsteps/s].               */
+static uint32_t            map_h[SPEED_MAP_SIZE];  /*!< Knot half period at the resolution of the move.   */
+static int64_t             map_dh[SPEED_MAP_SIZE]; /*!< Half period change per step (Q32) to next knot.   */
+static volatile int        x_map_active     = 0;   /*!< Target half period is taken from the map.         */
+static volatile int        x_map_dir        = 0;   /*!< Map move direction (1 - up).                      */
+static volatile int        x_map_idx        = 0;   /*!< Current map segment (-1 .. map_n-1).              */
+static volatile int64_t    x_map_hq         = 0;   /*!< Interpolated half period (Q32).                   */
+static volatile uint32_t   x_map_scale      = 1 << 16; /*!< Feed-rate override of the map (Q16, 100/percent). */
+static volatile uint32_t   x_map_hmin       = 0;   /*!< Shortest half period (planner limit).             */
 #endif
 
 
@@ -58,7 +94,11 @@ struct timer_regs {
 	uint32_t frc2_int;    /* 0x6000062C */
 	uint32_t frc2_alarm;  /* 0x60000630 */
 };
-static struct timer_regs* timer = (struct timer_regs*)(void*)(0x60000600);
+/* Register base (host builds in pc/host map it to memory) */
+#ifndef TIMER1_REGS_ADDR
+#define TIMER1_REGS_ADDR (0x60000600)
+#endif
+static struct timer_regs* timer = (struct timer_regs*)(void*)(TIMER1_REGS_ADDR);
 
 static void motion_intr_handler(void);
 
@@ -66,9 +106,13 @@ static void motion_intr_handler(void);
 
 static inline ICACHE_RAM_ATTR uint32_t GetCycleCount()
 {
+#ifdef __XTENSA__
 	uint32_t ccount;
 	__asm__ __volatile__("esync; rsr %0,ccount":"=a"(ccount));
 	return ccount;
+#else
+	return micros() * 80;
+#endif
 }
 //===========================================================================================
 
@@ -105,7 +149,10 @@ void Motion1D::printStat(CommandQueueItem *c)
 {
 	c->print("now="+String(GetCycleCount()) + "\r\nint_active="+String(int_active)+"\r\nin_motion="+String(in_motion)+"\r\n" + \
 		"x_pulse="+String(x_pulse)+ "\r\n" \
-		"x_pos="+String(x_pos)+",target = "+String(x_target)+"\r\nOK\r\n");
+		"x_pos="+String(x_pos)+",target = "+String(x_target)+"\r\nmicrosteps="+String(MICROSTEP_FINE >> x_shift)+"\r\n" \
+		"x_hperiod="+String(x_hperiod)+"\r\njog="+String(m_jogActive)+"\r\npaused="+String(m_paused)+"\r\n" \
+		"override="+String(m_override)+"\r\nmin_period="+String(planner_min_period)+"\r\n" \
+		"mscnt="+String(mscntExpected())+"\r\nlost_steps="+String(m_lostCount)+"\r\nhybrid="+String(m_hybrid)+"\r\nOK\r\n");
 }
 //===========================================================================================
 
@@ -126,11 +173,77 @@ Motion1D::Motion1D(int step1, int dir1, int en_pin)
 	in_motion       = 0;
 	m_en_pin        = en_pin;
 	m_motorsEnabled = 0;
+	m_jogActive     = 0;
+	m_jogSpeed      = 0;
+	m_jogLimit      = 0;
+	m_jogDeadline   = 0;
+	m_paused        = 0;
+	m_pauseTarget   = 0;
+	m_pauseHperiod  = 0;
+	m_pauseMap      = 0;
+	m_override      = 100;
+	m_cruiseHperiod = 0;
+	m_curveActive   = 0;
+	m_unitShift     = 0;
+	m_autoMs        = 1;
+	m_onResolution  = NULL;
+	m_resWait       = 0;
+	m_startWait     = 0;
+	m_phase         = 0;
+	m_lostCount     = 0;
+	m_lostLast      = 0;
+	m_lostPause     = 0;
+	m_hybridEnable  = 0;
+	m_hybrid        = HYBRID_OFF;
+	m_hybridEnd     = 0;
+	m_hybridHand    = 0;
+	m_hybridH       = 0;
+	m_hybridV       = 0;
+	m_hybridX       = 0;
+	m_hybridT       = 0;
+	m_hybridX0      = 0;
+	m_hybridT0      = 0;
+	m_hybridN       = 0;
+	m_hybridVDone   = 0;
+	m_hybridVOk     = 0;
+	m_hybridTries   = 0;
+	m_hybridMoveT   = 0;
+	m_hybridLost    = 0;
+	m_hybridFault   = 0;
+	m_hybridVSent   = 0;
+	m_hybridRead    = 0;
+	m_hybridStop    = 0;
+	m_onVelocity    = NULL;
+	m_onMscntRead   = NULL;
+	m_home          = HOME_OFF;
+	m_homeDir       = -1;
+	m_homeFast      = 0;
+	m_endPin        = -1;
+	m_endLevel      = LOW;
+	m_homeSingle    = 0;
+	m_onHome        = NULL;
+	m_encUnits      = 1;
+	m_encCounts     = 0;
+	m_encOffset     = 0;
+	m_encDeadband   = ENC_DEADBAND;
+	m_encLimit      = ENC_FOLLOW_MAX;
+	m_encCheck      = 0;
+	m_encTries      = 0;
+	m_encCorrections = 0;
+	m_encLast       = 0;
+	m_encFaults     = 0;
+	m_encFault      = 0;
+	m_moveSplit     = 0;
+	m_moveEnd       = 0;
+	m_movePeriod    = 0;
+	m_moveShift     = 0;
 	pinMode(en_pin, OUTPUT);
 	motorsOff();
 #ifdef MOTION_QUEUE_SIZE
 	m_motionQWr   = 0;
 	m_motionQRd   = 0;
+	m_loopOpenN   = 0;
+	m_loopLevel   = 0;
 #endif
 }
 //====================================================================================
@@ -138,13 +251,27 @@ Motion1D::Motion1D(int step1, int dir1, int en_pin)
 
 void Motion1D::stop()
 {
+	if (m_home != HOME_OFF) homeDone(HOME_CANCELLED);
 	/* Flush the motion Queue */
 #ifdef MOTION_QUEUE_SIZE
 	m_motionQWr   = 0;
 	m_motionQRd   = 0;
+	m_loopOpenN   = 0;
+	m_loopLevel   = 0;
 #endif
 	/* Stop timer 1 */
 	motion1D_timer1_disable();
+	x_dwell       = 0;
+	m_jogActive   = 0;
+	m_paused      = 0;
+	m_curveActive = 0;
+	m_moveSplit   = 0;
+	m_startWait   = 0;
+	m_encCheck    = 0;
+	m_encTries    = 0;
+	/* Driver back to the STEP input */
+	if ((m_hybrid >= HYBRID_HANDOFF) && (m_hybrid <= HYBRID_HANDBACK)) m_onVelocity(0);
+	m_hybrid      = HYBRID_OFF;
 	x_target = x_pos;
 	if (x_pulse) {
 		asm volatile ("" : : : "memory");
@@ -154,6 +281,112 @@ void Motion1D::stop()
 }
 //====================================================================================
 
+/*!
+ * \brief Controlled stop - flush the motion Queue and decelerate along the active ramp.
+ * On return x_target holds the final (stop) position.
+ */
+void Motion1D::softStop()
+{
+	if (m_home != HOME_OFF) homeDone(HOME_CANCELLED);
+#ifdef MOTION_QUEUE_SIZE
+	m_motionQWr   = 0;
+	m_motionQRd   = 0;
+	m_loopOpenN   = 0;
+	m_loopLevel   = 0;
+#endif
+	x_dwell     = 0;
+	m_jogSpeed  = 0;
+	m_paused    = 0;
+	if (m_hybrid == HYBRID_VACTUAL) hybridHandback();
+	m_moveSplit = 0;
+	curveToRamp();
+	brake();
+}
+//====================================================================================
+
+/*!
+ * \brief Decelerate to start/stop speed and stop as soon as possible.
+ * New target is placed exactly at the braking distance (never behind the current target),
+ * a move still waiting for the driver resolution change is not started at all.
+ */
+void Motion1D::brake()
+{
+	int b = 0;
+
+	noInterrupts();
+	if (m_startWait) {
+		m_startWait = 0;
+		x_target    = x_pos;
+		in_motion   = 0;
+	}
+	if (int_active) {
+#ifdef USE_RAMP
+		b = x_brake;
+#endif
+		b <<= x_shift;
+		if (x_target > x_pos) {
+			if ((x_pos + b) < x_target) x_target = x_pos + b;
+		} else {
+			if ((x_pos - b) > x_target) x_target = x_pos - b;
+		}
+	}
+	interrupts();
+}
+//====================================================================================
+
+/*!
+ * \brief Pause the motion queue - decelerate to halt, keep the rest of the segment and the queue.
+ */
+void Motion1D::pause()
+{
+	if ((m_paused) || (m_jogActive) || (m_home != HOME_OFF)) return;
+	if (m_hybrid == HYBRID_VACTUAL) hybridHandback();
+	m_paused       = 1;
+	m_pauseTarget  = x_target;
+	m_pauseHperiod = m_cruiseHperiod;
+#ifdef USE_RAMP
+	m_pauseMap     = x_map_active;
+#endif
+	if (m_curveActive) {
+		/* Rest of the curve is resumed as a constant speed move */
+		int r = m_curveX0 + m_curveDelta - x_pos;
+		if (r < 0) r = -r;
+		r >>= x_shift;
+		m_pauseTarget  = m_curveX0 + m_curveDelta;
+		m_pauseHperiod = (r) ? planner_hperiod(((m_curveDuration - m_curveT) * 80) / r) : RSTART_STOP_HPERIOD;
+		m_pauseMap     = 0;
+		curveToRamp();
+	}
+	brake();
+}
+//====================================================================================
+
+/*!
+ * \brief Resume paused motion - accelerate back into the interrupted segment and continue the queue.
+ */
+void Motion1D::resume()
+{
+	if (!m_paused) return;
+	if (int_active) {
+		/* Still braking - restore original target, ISR ramps up again */
+		noInterrupts();
+		x_target = m_pauseTarget;
+		interrupts();
+		m_paused = 0;
+		return;
+	}
+	m_paused  = 0;
+	in_motion = 0;
+	if (m_pauseTarget != x_target) {
+		if (m_pauseMap) {
+			mapStart(m_pauseTarget - x_target);
+		} else {
+			startMove(m_pauseTarget - x_target, m_pauseHperiod);
+		}
+	}
+}
+//====================================================================================
+
 /*!
  * \brief Disable Motors.
  */
@@ -188,191 +421,1502 @@ void Motion1D::toggleMotors()
 //====================================================================================
 
 /*!
- * \brief Prepare and start move.
+ * \brief Prepare and start move (dx in 1/256 microsteps, multiple of the user resolution).
  */
-void Motion1D::goToReal(int duration, int xSteps)
+void Motion1D::goToReal(int duration, int dx)
 {
-	uint64_t tmp;
 	if (in_motion) { return; }
-	if (!m_motorsEnabled) {motorsOn();}
-	
-	/* Disable timer */
-	motion1D_timer1_disable();
-	
-	in_motion       = 0;
-	x_pulse         = 0;
-	if (duration == 0) duration = 100;
-	/* Set target */
-	x_target += xSteps;
-	/* Set direction pin */
-	if (x_target > x_pos) digitalWrite(m_x_dir, HIGH); else digitalWrite(m_x_dir, LOW);
-	/* Prepare RAMP */
-#ifdef USE_RAMP
-	x_pos_start = x_pos;
-	if (x_target > x_pos) {
-		x_dir = 1;
-		x_pos_middle = x_pos - 2 + ((x_target - x_pos)>>1);
-	} else {
-		x_dir = 0;
-		x_pos_middle = x_pos + 2 - ((x_pos-x_target)>>1);
+	moveStart(x_target + dx, (planner_duration_period(duration, dx >> m_unitShift) << 8) >> m_unitShift);
+}
+//====================================================================================
+
+/*!
+ * \brief Start move to end position (in 1/256 microsteps) with period per 1/256 microstep (Q8).
+ * Resolution is selected from the speed (automatic mode), the move is split into pieces when
+ * its start or end is not aligned with the selected resolution.
+ */
+void Motion1D::moveStart(int end, uint64_t fperiod)
+{
+	m_moveEnd    = end;
+	m_movePeriod = fperiod;
+	m_moveShift  = m_unitShift;
+	if ((m_autoMs) && (m_onResolution)) {
+		m_moveShift = planner_auto_shift(fperiod, m_unitShift, 8 - __builtin_ctz(MICROSTEP_AUTO_MIN));
 	}
-	x_ramp_pos   = 0;
-	x_ramp_iter  = 0;
-	x_ramp_phase = 0;
-#endif
-	/* ABS */
-	if (xSteps < 0) xSteps = -xSteps;
-	/* Set period (timer1 clock  = 80MHz) */
-	if (xSteps) {
-		tmp = ((duration * 80000)/xSteps)-1;
+	m_moveSplit  = 1;
+	x_end_cut    = 0;
+	movePiece();
+}
+//====================================================================================
+
+/*!
+ * \brief Start next piece of the move.
+ * Resolution is changed only at MSCNT aligned points (multiple of the new STEP size), pieces:
+ * finer prefix up to the first aligned point, aligned middle, finer suffix.
+ */
+void Motion1D::movePiece()
+{
+	int x = x_target, e = m_moveEnd, s = m_moveShift, g = 1 << s, p, d;
+	uint32_t h;
+
+	if (x_end_cut) {
+		/* Stopped by the endstop - drop the rest of the move */
+		x_end_cut   = 0;
+		m_moveSplit = 0;
+		return;
+	}
+	if (x == e) {
+		m_moveSplit = 0;
+		return;
+	}
+	if ((!m_autoMs) || (!m_onResolution)) {
+		/* Fixed (user) resolution */
+		d = e - x;
 	} else {
-		tmp = 160000;
+		p = (x + m_phase) & (g - 1);
+		if (p) {
+			/* Prefix */
+			d = (e > x) ? (g - p) : -p;
+			if ((e > x) ? ((x + d) > e) : ((x + d) < e)) d = e - x;
+		} else {
+			/* Middle (or suffix when shorter than one STEP) */
+			d = ((e - x) / g) * g;
+			if (d == 0) d = e - x;
+		}
+		p = __builtin_ctz((x + m_phase) | d | g);
+		if (p < s) s = p;
 	}
-	if (tmp < MIN_PERIOD) tmp = MIN_PERIOD;
-#ifdef USE_RAMP
-	if (tmp < RMAXIMUM_PERIOD) tmp = RMAXIMUM_PERIOD;
+	h = planner_hperiod((m_movePeriod << s) >> 8);
+	setResolution(s);
+	hybridStart(d, h);
+	startMove(d, h);
+}
+//====================================================================================
 
-	if (tmp < RSTART_STOP_PERIOD) {
-		x_target_hperiod = ((tmp >> 1)&0xffffffff);
-		x_ramp_phase     = 1;
-		tmp = RSTART_STOP_PERIOD;
-	}
-#endif
-	/* Calculate half period */
-	x_hperiod = ((tmp >> 1)&0xffffffff);
+/*!
+ * \brief Set user resolution (microsteps per step, power of 2) - unit of the motion commands.
+ * Positions (and queued moves) are kept in 1/256 microsteps, so nothing has to be rescaled,
+ * the driver is switched now (at standstill) or at the start of the next segment.
+ */
+void Motion1D::setMicrosteps(int microsteps)
+{
+	int s = unitShift(microsteps);
 
-	/* Start timer1 */
-	in_motion  = 1;
-	
-	/* Start timer */
-	motion1D_timer1_enable();
+	m_unitShift = s;
+	if (!isInMotion()) setResolution(s);
 }
 //====================================================================================
 
 /*!
- * \brief Executed in main loop.
+ * \brief Position unit shift of the user resolution (rounded down to a power of 2).
  */
-boolean Motion1D::loop()
+int Motion1D::unitShift(int microsteps)
 {
-#ifdef MOTION_QUEUE_SIZE
-	if (in_motion) {
-		if (int_active == 0) {
-			in_motion = 0;
-			motionQ_pull();
-		}
-	} else {
-		motionQ_pull();
-	}
-	return motionQ_is_full();
-#else
-	if (in_motion) {
-		if (int_active == 0) {
-			in_motion = 0;
-		}
+	int s;
+
+	for (s = 0; (s < 8) && ((MICROSTEP_FINE >> s) > microsteps); ++s);
+	return s;
+}
+//====================================================================================
+
+/*!
+ * \brief Select driver resolution automatically from the planned speed of moves
+ * (disabled - moves use the user resolution).
+ */
+void Motion1D::setAutoMicrosteps(boolean enable)
+{
+	m_autoMs = enable;
+	if ((!enable) && (!isInMotion())) setResolution(m_unitShift);
+}
+//====================================================================================
+
+/*!
+ * \brief Set driver resolution (1/256 microsteps per STEP = 1 << shift) - at standstill only.
+ * A move started before the driver confirms the change (resolutionDone()) waits for it.
+ */
+void Motion1D::setResolution(int shift)
+{
+	if (shift == x_shift) return;
+	x_shift = shift;
+	if (m_onResolution) {
+		m_resWait = 1;
+		m_onResolution(MICROSTEP_FINE >> shift);
 	}
-	return in_motion;
-#endif
 }
 //====================================================================================
 
 /*!
- * \brief Check in motion flag.
+ * \brief Resolution for a segment of dx (in 1/256 microsteps) - user resolution or finer
+ * when the distance is not a multiple of it.
  */
-boolean Motion1D::isInMotion()
+int Motion1D::segmentShift(int dx)
 {
-	if (in_motion) return true;
-#ifdef MOTION_QUEUE_SIZE
-	if (m_motionQWr  != m_motionQRd) return true;
-#endif	
-	return false;
+	int s = __builtin_ctz(dx | (1 << m_unitShift));
+
+	return (s < m_unitShift) ? s : m_unitShift;
 }
 //====================================================================================
 
-// Speed critical bits
-#pragma GCC optimize ("O2")
-// Normally would not want two copies like this, but due to different
-// optimization levels the inline attribute gets lost if we try the
-// other version.
+/*!
+ * \brief Current position in 1/256 microsteps.
+ */
+int Motion1D::position()
+{
+	return x_pos;
+}
+//====================================================================================
 
-//static inline ICACHE_RAM_ATTR uint32_t GetCycleCountIRQ()
-//{
-//	uint32_t ccount;
-//	__asm__ __volatile__("rsr %0,ccount":"=a"(ccount));
-//	return ccount;
-//}
-//===========================================================================================
+/*!
+ * \brief Target position in 1/256 microsteps.
+ */
+int Motion1D::target()
+{
+	return x_target;
+}
+//====================================================================================
 
 /*!
- * \brief timer1 interrupt handler.
+ * \brief Stop and set this position as zero point (driver MSCNT phase is kept).
  */
-void ICACHE_RAM_ATTR motion_intr_handler(void)
+void Motion1D::setZero()
 {
-	/* Clear interrupt mask */
-	timer->frc1_int &= ~FRC1_INT_CLR_MASK;
-	if (x_pulse) {
-		asm volatile ("" : : : "memory");
-		gpio_r->out_w1tc = (uint32_t)(x_gpio_mask);
-		x_pulse = 0;
-		if (x_pos == x_target) {
-			/* We are in target position :-) - disable timer */
-			timer->frc1_int &= ~FRC1_INT_CLR_MASK;
-			timer->frc1_ctrl = 0;
-			int_active = 0;
-		}
+	stop();
+	m_phase     += x_pos;
+	m_encOffset -= x_pos;
+	x_pos        = 0;
+	x_target     = 0;
+}
+//====================================================================================
+
+/*!
+ * \brief Stop and make pos (in 1/256 microsteps) the zero point (e.g. latched endstop position).
+ */
+void Motion1D::setZeroAt(int pos)
+{
+	stop();
+	m_phase      = (m_phase + pos) & (MSCNT_CYCLE - 1);
+	m_encOffset -= pos;
+	x_pos       -= pos;
+	x_target     = x_pos;
+}
+//====================================================================================
+
+/*!
+ * \brief Endstop edge interrupt - latch the position at the trigger step and decelerate
+ * (stop at once below start/stop speed or at a hard stop - sensorless homing).
+ * Unarmed edge while moving is a stall (crash) when stall detection is enabled - STEP pulses stop at once.
+ */
+static void ICACHE_RAM_ATTR endstop_intr_handler(void)
+{
+	int b = 0;
+
+	if (!x_end_armed) {
+		if ((!x_stall_enabled) || (!in_motion)) return;
+		x_stall_pos = x_pos;
+		x_stall_hit = 1;
+		x_target    = x_pos;
+		return;
+	}
+	x_end_armed = 0;
+	x_end_pos   = x_pos;
+	x_end_hit   = 1;
+	if (!int_active) return;
 #ifdef USE_RAMP
-		/* Tabled ramp implementation */
-		else if (x_ramp_phase) {
-			if (x_ramp_phase == 1) {
-				/* Ramp UP */
-				if (x_hperiod > x_target_hperiod) {
-					if (x_ramp_iter == 0) {
-						x_hperiod--;
-						RTC_REG_WRITE(FRC1_LOAD_ADDRESS, x_hperiod);
-						x_ramp_iter = ramp[x_ramp_pos++];
-						/* Recalculate middle point */
-						if (x_hperiod == x_target_hperiod) {
-							if (x_dir == 1) {
-								x_ramp_len   = x_pos - x_pos_start;
-								x_pos_middle = x_target - x_ramp_len;
-							} else {
-								x_ramp_len = x_pos_start - x_pos;
-								x_pos_middle = x_target + x_ramp_len;
-							}
-						}
-					} else {
-						x_ramp_iter--;
-					}
-				}
-				/* Check middle point */
-				if (x_dir == 1) {
-					if (x_pos > x_pos_middle) {x_ramp_phase = 2;}
-				} else {
-					if (x_pos < x_pos_middle) {x_ramp_phase = 2;}
-				}
-			} else {
-				/* Ramp DOWN */
-				if (x_hperiod < RSTART_STOP_HPERIOD) {
-					if (x_ramp_iter == 0) {
-						x_hperiod++;
-						RTC_REG_WRITE(FRC1_LOAD_ADDRESS, x_hperiod);
-						x_ramp_iter = ramp[x_ramp_pos--];
-					} else {
-						x_ramp_iter--;
-					}
-				}
-			}
-		}
+	if (!x_end_hard) b = x_brake;
 #endif
-	} else if (x_pos != x_target) {
-		asm volatile ("" : : : "memory");
-		gpio_r->out_w1ts = (uint32_t)(x_gpio_mask);
-		x_pulse = 1;
-		if (x_pos > x_target) x_pos--; else x_pos++;
+	b <<= x_shift;
+	if (x_target > x_pos) {
+		if ((x_pos + b) < x_target) x_target = x_pos + b;
 	} else {
-		/* We are in target position :-) - disable timer */
-		timer->frc1_int &= ~FRC1_INT_CLR_MASK;
-		timer->frc1_ctrl = 0;
-		int_active = 0;
+		if ((x_pos - b) > x_target) x_target = x_pos - b;
+	}
+	x_end_cut = 1;
+}
+//====================================================================================
+
+/*!
+ * \brief Attach endstop interrupt (switch - active low, driver DIAG output - active high).
+ */
+void Motion1D::endstopBegin(int pin, int level)
+{
+	m_endPin   = pin;
+	m_endLevel = level;
+	attachInterrupt(digitalPinToInterrupt(pin), endstop_intr_handler, (level) ? RISING : FALLING);
+}
+//====================================================================================
+
+/*!
+ * \brief Endstop is active now.
+ */
+boolean Motion1D::endstopActive()
+{
+	return (m_endPin >= 0) && (digitalRead(m_endPin) == m_endLevel);
+}
+//====================================================================================
+
+/*!
+ * \brief Stop the motion at an unarmed endstop edge (driver stall output), reported by stallHit().
+ */
+void Motion1D::stallDetect(boolean enable)
+{
+	x_stall_hit     = 0;
+	x_stall_enabled = enable;
+}
+//====================================================================================
+
+/*!
+ * \brief Stall was detected since the last call (pos - position at the stall).
+ */
+boolean Motion1D::stallHit(int *pos)
+{
+	if (!x_stall_hit) return false;
+	*pos        = x_stall_pos;
+	x_stall_hit = 0;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Latch the position at the next endstop edge and stop the running move there.
+ */
+void Motion1D::endstopArm()
+{
+	noInterrupts();
+	x_end_hit   = 0;
+	x_end_armed = 1;
+	interrupts();
+}
+//====================================================================================
+
+void Motion1D::endstopDisarm()
+{
+	x_end_armed = 0;
+}
+//====================================================================================
+
+/*!
+ * \brief Endstop was triggered since endstopArm().
+ */
+boolean Motion1D::endstopHit()
+{
+	return x_end_hit;
+}
+//====================================================================================
+
+/*!
+ * \brief Position (in 1/256 microsteps) latched at the endstop edge.
+ */
+int Motion1D::endstopPos()
+{
+	return x_end_pos;
+}
+//====================================================================================
+
+/*!
+ * \brief Quadrature decoder - executed on every edge of both encoder channels.
+ */
+static void ICACHE_RAM_ATTR encoder_intr_handler(void)
+{
+	int s = (digitalRead(x_enc_a) << 1) | digitalRead(x_enc_b);
+	int d = enc_table[(x_enc_state << 2) | s];
+
+	x_enc_state = s;
+	if (d == ENC_INVALID) {
+		x_enc_invalid++;
+	} else {
+		x_enc_count += d;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Attach quadrature encoder (A, B inputs) interrupts - feedback is enabled by setEncoder().
+ */
+void Motion1D::encoderBegin(int pinA, int pinB)
+{
+	x_enc_a     = pinA;
+	x_enc_b     = pinB;
+	x_enc_state = (digitalRead(pinA) << 1) | digitalRead(pinB);
+	attachInterrupt(digitalPinToInterrupt(pinA), encoder_intr_handler, CHANGE);
+	attachInterrupt(digitalPinToInterrupt(pinB), encoder_intr_handler, CHANGE);
+}
+//====================================================================================
+
+/*!
+ * \brief Encoder feedback - units (1/256 microsteps) per counts (0 - disabled, < 0 - reversed),
+ * end-of-move error left uncorrected (at least one count) and following error limit in 1/256 microsteps.
+ * The encoder is synchronized with the current position.
+ */
+void Motion1D::setEncoder(int units, int counts, int deadband, int limit)
+{
+	int c = (counts < 0) ? -counts : counts;
+
+	m_encUnits    = units;
+	m_encCounts   = counts;
+	m_encDeadband = deadband;
+	if ((c) && (m_encDeadband < ((units + c - 1) / c))) m_encDeadband = (units + c - 1) / c;
+	m_encLimit    = (limit > m_encDeadband) ? limit : m_encDeadband;
+	m_encCheck    = 0;
+	m_encTries    = 0;
+	m_encFault    = 0;
+	if (counts) encoderSync();
+}
+//====================================================================================
+
+/*!
+ * \brief Position measured by the encoder (in 1/256 microsteps).
+ */
+int Motion1D::encoderPosition()
+{
+	if (!m_encCounts) return x_pos;
+	return m_encOffset + (int)(((int64_t)x_enc_count * m_encUnits) / m_encCounts);
+}
+//====================================================================================
+
+/*!
+ * \brief Take the current position as the encoder reference.
+ */
+void Motion1D::encoderSync()
+{
+	m_encOffset = 0;
+	m_encOffset = x_pos - encoderPosition();
+}
+//====================================================================================
+
+/*!
+ * \brief Following error monitor (polled from loop()) - stop when the motor lags the STEP
+ * pulses by more than the limit (stall, crash), the encoder position is taken as the real one.
+ */
+void Motion1D::encoderMonitor()
+{
+	int e;
+
+	if ((!m_encCounts) || (!isInMotion())) return;
+	e = encoderPosition() - x_pos;
+	if ((e <= m_encLimit) && (e >= -m_encLimit)) return;
+	stop();
+	/* Driver MSCNT phase is kept */
+	x_pos      += e;
+	x_target    = x_pos;
+	m_phase     = (m_phase - e) & (MSCNT_CYCLE - 1);
+	m_encFaults++;
+	m_encFault  = e;
+}
+//====================================================================================
+
+/*!
+ * \brief End-of-move correction - compare the encoder with the position when a queued move
+ * (and its correction) ends, a bigger error than the dead band is corrected by a STEP move to
+ * the target before the next queue entry.
+ * \return true when a correction move was started.
+ */
+boolean Motion1D::encoderCorrect()
+{
+	int e, t, s;
+
+	if ((!m_encCheck) || (!m_encCounts)) return false;
+	m_encCheck = 0;
+	e = encoderPosition() - x_pos;
+	if (((e <= m_encDeadband) && (e >= -m_encDeadband)) || (m_encTries >= ENC_CORRECT_TRIES)) {
+		m_encTries = 0;
+		return false;
+	}
+	m_encTries++;
+	m_encCorrections++;
+	m_encLast  = e;
+	/* Encoder is the real position (driver MSCNT phase is kept), approach the target slowly */
+	t          = x_target;
+	x_pos     += e;
+	x_target   = x_pos;
+	m_phase    = (m_phase - e) & (MSCNT_CYCLE - 1);
+	s          = __builtin_ctz((x_pos + m_phase) | (t - x_pos) | (1 << x_shift));
+	setResolution((s < x_shift) ? s : x_shift);
+	startMove(t - x_pos, RSTART_STOP_HPERIOD);
+	m_encCheck = 1;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Following error fault since the last call (err - error in 1/256 microsteps).
+ */
+boolean Motion1D::encoderFault(int *err)
+{
+	if (!m_encFault) return false;
+	*err       = m_encFault;
+	m_encFault = 0;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Invalid encoder transitions (noise or too fast signal).
+ */
+uint32_t Motion1D::encoderInvalid()
+{
+	return x_enc_invalid;
+}
+//====================================================================================
+
+/*!
+ * \brief Start homing cycle (MOTION_CMD_HOME) - fast approach up to dx at speed [1/256 microsteps/s].
+ * Passes are chained by homeNext() at the end of every move, the queue waits for the result.
+ */
+void Motion1D::homeStart(int dx, int speed)
+{
+	m_homeDir  = (dx < 0) ? -1 : 1;
+	m_homeFast = ((uint64_t)PLANNER_CLOCK << 8) / speed;
+	m_home     = HOME_SEEK;
+	x_end_hard = m_homeSingle;
+	if (m_endPin < 0) {
+		homeDone(HOME_NOT_FOUND);
+		return;
+	}
+	if (endstopActive()) {
+		/* Switch already pressed - back off first */
+		x_end_pos = x_pos;
+		x_end_hit = 1;
+		homeNext();
+		return;
+	}
+	endstopArm();
+	moveStart(x_target + dx, m_homeFast);
+}
+//====================================================================================
+
+/*!
+ * \brief Homing cycle - previous pass finished, start the next one.
+ * Seek (fast), back-off from the latched position, slow seek (stops at the trigger step), zero.
+ */
+void Motion1D::homeNext()
+{
+	switch (m_home) {
+		case HOME_SEEK:
+			endstopDisarm();
+			if (!x_end_hit) {
+				homeDone(HOME_NOT_FOUND);
+				return;
+			}
+			if (m_homeSingle) {
+				homeZero();
+				return;
+			}
+			m_home = HOME_BACK;
+			moveStart(x_end_pos - m_homeDir * HOME_BACKOFF, m_homeFast);
+			break;
+		case HOME_BACK:
+			if (endstopActive()) {
+				homeDone(HOME_NOT_RELEASED);
+				return;
+			}
+			m_home = HOME_SLOW;
+			endstopArm();
+			moveStart(x_target + m_homeDir * 2 * HOME_BACKOFF, ((uint64_t)PLANNER_CLOCK << 8) / HOME_SLOW_SPEED);
+			break;
+		case HOME_SLOW:
+			endstopDisarm();
+			if (!x_end_hit) {
+				homeDone(HOME_NOT_FOUND);
+				return;
+			}
+			homeZero();
+			break;
+		default: break;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Homing cycle - latched position is the new zero (driver MSCNT phase is kept).
+ */
+void Motion1D::homeZero()
+{
+	m_phase      = (m_phase + x_end_pos) & (MSCNT_CYCLE - 1);
+	m_encOffset -= x_end_pos;
+	x_pos       -= x_end_pos;
+	x_target     = x_pos;
+	homeDone(HOME_OK);
+}
+//====================================================================================
+
+/*!
+ * \brief Homing cycle finished - report the result, queued moves are dropped on failure
+ * (they were planned from the new zero).
+ */
+void Motion1D::homeDone(int result)
+{
+	m_home = HOME_OFF;
+	endstopDisarm();
+#ifdef MOTION_QUEUE_SIZE
+	if (result != HOME_OK) {
+		m_motionQWr = 0;
+		m_motionQRd = 0;
+		m_loopOpenN = 0;
+		m_loopLevel = 0;
+	}
+#endif
+	if (m_onHome) m_onHome(result);
+}
+//====================================================================================
+
+/*!
+ * \brief Take driver MSCNT read at standstill as the reference of the current position.
+ */
+void Motion1D::mscntSync(int mscnt)
+{
+	m_phase = (mscnt - x_pos) & (MSCNT_CYCLE - 1);
+}
+//====================================================================================
+
+/*!
+ * \brief Compare driver MSCNT read at standstill with the position.
+ * Mismatch (lost or extra steps, modulo 4 full steps) is counted, the reference is moved to
+ * the real motor position and the queue is paused when enabled.
+ * \return mismatch in 1/256 microsteps (0 - motor followed the STEP pulses).
+ */
+int Motion1D::mscntCheck(int mscnt)
+{
+	int d = (mscnt - mscntExpected()) & (MSCNT_CYCLE - 1);
+
+	if (d >= (MSCNT_CYCLE / 2)) d -= MSCNT_CYCLE;
+	if (d == 0) return 0;
+	m_lostCount++;
+	m_lostLast = d;
+	m_phase    = (m_phase + d) & (MSCNT_CYCLE - 1);
+	if (m_lostPause) pause();
+	return d;
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise - check if the move is long enough to hand its cruise to the driver.
+ * The speed is limited, so the worst-case VACTUAL speed error accumulated over the longest MSCNT
+ * sample gap stays within the unwrap range (the position is not lost between the samples).
+ * \param dx      - distance in 1/256 microsteps,
+ * \param hperiod - cruise half period.
+ */
+void Motion1D::hybridStart(int dx, uint32_t hperiod)
+{
+#ifdef USE_RAMP
+	int64_t n = ((dx < 0) ? -dx : dx) >> x_shift;
+
+	if ((!m_hybridEnable) || (!m_onVelocity) || (!m_onMscntRead) || (!m_onResolution) || (m_override != 100)) return;
+	/* The endstop can stop STEP pulses only */
+	if (x_end_armed) return;
+	/* Speed error over the sample gap must stay within HYBRID_TRACK_ERR */
+	if (((int64_t)(40 << x_shift) * HYBRID_SPEED_ERR * HYBRID_GAP_US) > ((int64_t)HYBRID_TRACK_ERR * 100 * hperiod)) return;
+	/* Cruise steps left after both ramps and the hand back margin */
+	n -= 2 * planner_brake_steps(hperiod) + ((int64_t)HYBRID_HANDBACK_US * 40) / hperiod;
+	if ((n * 2 * hperiod) < ((int64_t)HYBRID_MIN_MS * 80000)) return;
+	m_hybrid     = HYBRID_RAMP;
+	m_hybridEnd  = x_target + dx;
+	m_hybridLost = 0;
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise - predicted position at time t (micros).
+ */
+static inline int hybridPredict(int x, int64_t v, uint32_t t0, uint32_t t)
+{
+	return x + (int)((v * (int32_t)(t - t0)) >> 16);
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise state machine (polled from loop()).
+ * The cruise speed is handed to the driver internal step generator (VACTUAL) and the STEP
+ * pulses stop only when the driver confirmed the write (IFCNT). MSCNT is polled all the time and
+ * unwrapped around the predicted position (MSCNT repeats every 4 full steps), the STEP pulses take
+ * over before the brake point, when a sample is late or when the tracked position stops advancing.
+ * \return true when the hybrid cruise owns the motion.
+ */
+boolean Motion1D::hybridLoop()
+{
+#ifdef USE_RAMP
+	int64_t  v;
+	int      b, vactual;
+	uint32_t t;
+
+	switch (m_hybrid) {
+		case HYBRID_RAMP:
+			/* STEP pulses accelerate to the cruise speed */
+			if (int_active == 0) {
+				m_hybrid = HYBRID_OFF;
+				return false;
+			}
+			if ((m_paused) || (x_target != m_hybridEnd) || (x_hperiod != x_target_hperiod)) return false;
+			m_hybridH = x_target_hperiod;
+			v         = ((int64_t)40 << (x_shift + 16)) / m_hybridH;
+			vactual   = (int)((((uint64_t)40000000) << 24) / ((uint64_t)m_hybridH * VACTUAL_CLOCK));
+			b         = (planner_brake_steps(m_hybridH) + (HYBRID_HANDBACK_US * 40) / m_hybridH) << x_shift;
+			if (m_hybridEnd < x_pos) {
+				v       = -v;
+				vactual = -vactual;
+				b       = -b;
+			}
+			m_hybridV    = v;
+			m_hybridHand = m_hybridEnd - b;
+			/* Not worth the hand over any more */
+			if (((((int64_t)(m_hybridHand - x_pos)) << 16) / v) < (HYBRID_MIN_MS * 500)) {
+				m_hybrid = HYBRID_OFF;
+				return false;
+			}
+			if (!m_onVelocity(vactual)) return false;
+			m_hybridVDone = 0;
+			m_hybrid      = HYBRID_HANDOFF;
+			return true;
+		case HYBRID_HANDOFF:
+			/* STEP pulses run until the driver confirms VACTUAL */
+			if (!m_hybridVDone) return true;
+			if ((!m_hybridVOk) || (m_paused) || (x_target != m_hybridEnd) || (int_active == 0)) {
+				/* Not confirmed or stopped meanwhile - back to the STEP input */
+				m_hybridVDone = 0;
+				m_hybridTries = 0;
+				m_hybridVSent = m_onVelocity(0);
+				m_hybrid      = HYBRID_HANDBACK;
+				return true;
+			}
+			motion1D_timer1_disable();
+			if (x_pulse) {
+				asm volatile ("" : : : "memory");
+				gpio_r->out_w1tc = (uint32_t)(x_gpio_mask);
+				x_pulse = 0;
+			}
+			m_hybridX     = x_pos;
+			m_hybridT     = micros();
+			m_hybridMoveT = m_hybridT;
+			m_hybridN     = 0;
+			m_hybridRead  = 0;
+			m_hybrid      = HYBRID_VACTUAL;
+			return true;
+		case HYBRID_VACTUAL:
+			t     = micros();
+			x_pos = hybridPredict(m_hybridX, m_hybridV, m_hybridT, t);
+			/* Late sample - hand back before the prediction error exceeds the unwrap range */
+			if ((t - m_hybridT) > HYBRID_GAP_US) {
+				hybridHandback();
+				if ((t - m_hybridT) > 2 * HYBRID_GAP_US) m_hybridLost = 1;
+				return true;
+			}
+			if ((m_hybridLost) || ((m_hybridV > 0) ? (x_pos >= m_hybridHand) : (x_pos <= m_hybridHand))) {
+				hybridHandback();
+				return true;
+			}
+			if ((!m_hybridRead) && (m_onMscntRead())) m_hybridRead = 1;
+			return true;
+		case HYBRID_HANDBACK:
+			/* STEP pulses brake to the target */
+			if (!m_hybridVSent) m_hybridVSent = m_onVelocity(0);
+			if ((m_hybridVDone) && (!m_hybridVOk) && (++m_hybridTries < HYBRID_RETRIES)) {
+				/* VACTUAL = 0 not confirmed - repeat */
+				m_hybridVDone = 0;
+				m_hybridVSent = m_onVelocity(0);
+			}
+			if ((int_active) || (!m_hybridVDone)) return true;
+			/* Driver may still run from VACTUAL */
+			if (!m_hybridVOk) m_hybridLost = 1;
+			m_hybridRead = 0;
+			m_hybridStop = millis();
+			m_hybrid     = HYBRID_FINAL;
+			return true;
+		case HYBRID_FINAL:
+			/* Standstill - read the real position */
+			if ((!m_hybridRead) && ((millis() - m_hybridStop) >= HYBRID_SETTLE_MS) && (m_onMscntRead())) m_hybridRead = 1;
+			return true;
+	}
+#endif
+	m_hybrid = HYBRID_OFF;
+	return false;
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise - STEP pulses take over from VACTUAL at the cruise speed.
+ * Both run at the same speed until the driver confirms VACTUAL = 0 (STEP input ignored meanwhile).
+ * When the driver stopped (tracking lost) the STEP pulses continue from the last tracked position.
+ */
+void Motion1D::hybridHandback()
+{
+#ifdef USE_RAMP
+	int x, g = 1 << x_shift;
+
+	if (m_hybrid != HYBRID_VACTUAL) return;
+	/* Continue from the STEP grid of the move */
+	x = (m_hybridLost) ? m_hybridX : hybridPredict(m_hybridX, m_hybridV, m_hybridT, micros());
+	x = m_hybridEnd - ((m_hybridEnd - x) / g) * g;
+	x_pos            = x;
+	x_pulse          = 0;
+	x_target_hperiod = m_hybridH;
+	x_hperiod        = m_hybridH;
+	x_ramp_iter      = 0;
+	x_brake          = planner_brake_steps(m_hybridH);
+	x_ramp_enabled   = 1;
+	x_map_active     = 0;
+	if (x_target > x_pos) digitalWrite(m_x_dir, HIGH); else digitalWrite(m_x_dir, LOW);
+	motion1D_timer1_enable();
+	m_hybridVDone = 0;
+	m_hybridTries = 0;
+	m_hybridVSent = m_onVelocity(0);
+	m_hybrid      = HYBRID_HANDBACK;
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise - driver MSCNT read at time t (micros, end of the read request).
+ * While VACTUAL runs the sample is unwrapped around the predicted position and updates the
+ * tracked position and measured speed, a sample far from the prediction or a position not advancing
+ * for HYBRID_GAP_US means the driver stopped. At the final standstill the rest is corrected by
+ * STEP pulses, the correction is modulo MSCNT_CYCLE, so a tracking loss is reported as lost steps
+ * (position not verified).
+ */
+void Motion1D::hybridMscnt(boolean ok, int mscnt, uint32_t t)
+{
+	int x, d;
+
+	m_hybridRead = 0;
+	if (!ok) return;
+	if (m_hybrid == HYBRID_VACTUAL) {
+		x = hybridPredict(m_hybridX, m_hybridV, m_hybridT, t);
+		d = (mscnt - ((x + m_phase) & (MSCNT_CYCLE - 1))) & (MSCNT_CYCLE - 1);
+		if (d >= (MSCNT_CYCLE / 2)) d -= MSCNT_CYCLE;
+		x += d;
+		if ((d > HYBRID_TRACK_ERR) || (d < -HYBRID_TRACK_ERR)) m_hybridLost = 1;
+		if ((m_hybridV > 0) ? (x > m_hybridX) : (x < m_hybridX)) {
+			m_hybridMoveT = t;
+		} else if ((t - m_hybridMoveT) > HYBRID_GAP_US) {
+			m_hybridLost = 1;
+		}
+		if (m_hybridN == 0) {
+			m_hybridX0 = x;
+			m_hybridT0 = t;
+		} else if ((t - m_hybridT0) >= 10000) {
+			/* Measured speed (driver clock differs from VACTUAL_CLOCK) */
+			m_hybridV = (((int64_t)(x - m_hybridX0)) << 16) / (int32_t)(t - m_hybridT0);
+		}
+		m_hybridN++;
+		m_hybridX = x;
+		m_hybridT = t;
+	} else if (m_hybrid == HYBRID_FINAL) {
+		d = (mscnt - mscntExpected()) & (MSCNT_CYCLE - 1);
+		if (d >= (MSCNT_CYCLE / 2)) d -= MSCNT_CYCLE;
+		m_hybrid = HYBRID_OFF;
+		if ((m_hybridLost) || (d > HYBRID_TRACK_ERR) || (d < -HYBRID_TRACK_ERR)) {
+			/* Whole MSCNT cycles may be missing */
+			m_lostCount++;
+			m_lostLast    = d;
+			m_hybridFault = 1;
+			if (m_lostPause) pause();
+		}
+		x        = x_target;
+		x_pos   += d;
+		x_target = x_pos;
+		if (x != x_pos) {
+			/* Hand over error - approach the target with STEP pulses */
+			d = __builtin_ctz((x_pos + m_phase) | (x - x_pos) | (1 << x_shift));
+			in_motion = 0;
+			setResolution((d < x_shift) ? d : x_shift);
+			startMove(x - x_pos, RSTART_STOP_HPERIOD);
+		}
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise tracking loss since the last call (position is not verified).
+ */
+boolean Motion1D::hybridFault()
+{
+	if (!m_hybridFault) return false;
+	m_hybridFault = 0;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Start move with given (cruise) half period.
+ * \param dx      - distance in 1/256 microsteps (multiple of the driver STEP),
+ * \param hperiod - half period of the driver STEP.
+ */
+void Motion1D::startMove(int dx, uint32_t hperiod, boolean useMap)
+{
+	if (in_motion) { return; }
+	if (!m_motorsEnabled) {motorsOn();}
+	
+	/* Disable timer */
+	motion1D_timer1_disable();
+	
+	/* Feed-rate override (not used in jog mode) */
+	m_cruiseHperiod = hperiod;
+	if ((!m_jogActive) && (m_override != 100)) hperiod = planner_override(hperiod, m_override);
+	in_motion       = 0;
+	x_pulse         = 0;
+	/* Set target */
+	x_target += dx;
+	/* Set direction pin */
+	if (x_target > x_pos) digitalWrite(m_x_dir, HIGH); else digitalWrite(m_x_dir, LOW);
+	/* Prepare RAMP (start at start/stop speed) */
+#ifdef USE_RAMP
+	x_target_hperiod = hperiod;
+	x_ramp_iter      = 0;
+	x_brake          = 0;
+	x_ramp_enabled   = 1;
+	x_map_active     = useMap;
+	if (hperiod < RSTART_STOP_HPERIOD) hperiod = RSTART_STOP_HPERIOD;
+#endif
+	x_hperiod = hperiod;
+
+	/* Start timer1 */
+	in_motion  = 1;
+	
+	/* Start timer (loop() starts it when the driver confirms the resolution change) */
+	if (m_resWait) m_startWait = 1; else motion1D_timer1_enable();
+}
+//====================================================================================
+
+/*!
+ * \brief Velocity (jog) mode.
+ * \param speed   - speed in [microsteps/s] (signed), 0 - decelerate and stop,
+ * \param limit   - do not go behind this position (in the speed direction),
+ * \param timeout - dead-man timeout in [ms] (brake when no new request arrives).
+ * Speed may be updated at any time, the ISR ramps to the new setpoint.
+ */
+void Motion1D::jog(int speed, int limit, int timeout)
+{
+	int aS = speed;
+
+	if (aS < 0) aS = -aS;
+	m_jogSpeed    = speed;
+	m_jogLimit    = limit;
+	m_jogDeadline = millis() + timeout;
+	if (m_jogActive == 0) {
+		if ((speed == 0) || (isInMotion())) return;
+		m_jogActive = 1;
+		setResolution(m_unitShift);
+		startMove(limit - x_target, planner_speed_hperiod(aS));
+		return;
+	}
+	if ((speed == 0) || ((speed > 0) != (x_target > x_pos))) {
+		/* Stop or reverse - decelerate first (loop() restarts in the new direction) */
+		brake();
+		return;
+	}
+	/* Update setpoint on the fly */
+	noInterrupts();
+	x_target = limit;
+	interrupts();
+#ifdef USE_RAMP
+	x_target_hperiod = planner_speed_hperiod(aS);
+#else
+	x_hperiod = planner_speed_hperiod(aS);
+	RTC_REG_WRITE(FRC1_LOAD_ADDRESS, x_hperiod);
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Set feed-rate override in [%] - applied live to the running segment and to queued segments.
+ * The ISR ramps to the new speed.
+ */
+void Motion1D::setOverride(int percent)
+{
+	uint32_t h;
+
+	if (m_hybrid == HYBRID_VACTUAL) hybridHandback();
+	m_override = percent;
+#ifdef USE_RAMP
+	x_map_scale = ((uint32_t)100 << 16) / percent;
+#endif
+	if ((int_active) && (!m_jogActive) && (!m_curveActive)) {
+		h = planner_override(m_cruiseHperiod, percent);
+#ifdef USE_RAMP
+		x_target_hperiod = h;
+#else
+		x_hperiod = h;
+		RTC_REG_WRITE(FRC1_LOAD_ADDRESS, x_hperiod);
+#endif
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Start hardware timed dwell (Timer1 runs with 1ms period without STEP pulses).
+ */
+void Motion1D::dwellStart(int duration)
+{
+	if (in_motion) { return; }
+	motion1D_timer1_disable();
+	x_pulse   = 0;
+	x_target  = x_pos;
+	x_dwell   = duration;
+	x_hperiod = 80000;
+	if (duration <= 0) return;
+	in_motion = 1;
+	motion1D_timer1_enable();
+}
+//====================================================================================
+
+/*!
+ * \brief Step rate self-test - run the step generator at constant half period (no ramp)
+ * steps forward and back (position is restored) and measure ISR timing.
+ * Blocks until both runs are done, motor driver state is not changed.
+ * \param hperiod - half period in clock cycles,
+ * \param steps   - steps in each direction,
+ * \param r       - result (intervals and ISR duration in clock cycles),
+ * \param room    - free distance in 1/256 microsteps (sign - direction of the first run, 0 - not limited),
+ *                  steps are limited to it.
+ * \return false when the slider is in motion or there is no room.
+ */
+boolean Motion1D::rateTest(uint32_t hperiod, int steps, motion_rate_t *r, int room)
+{
+	int n = ((room < 0) ? -room : room) >> x_shift;
+
+	if (isInMotion()) return false;
+	if (room) {
+		if (steps > n) steps = n;
+		if (steps == 0) return false;
+		if (room < 0) steps = -steps;
+	}
+	x_test_late    = 0;
+	x_test_dmax    = 0;
+	x_test_isr_max = 0;
+	for (int i = 0; i < 2; ++i) {
+		motion1D_timer1_disable();
+		x_pulse   = 0;
+		x_target += ((i) ? -steps : steps) << x_shift;
+		if (x_target > x_pos) digitalWrite(m_x_dir, HIGH); else digitalWrite(m_x_dir, LOW);
+#ifdef USE_RAMP
+		x_ramp_enabled = 0;
+		x_map_active   = 0;
+#endif
+		x_hperiod     = hperiod;
+		x_test_last   = 0;
+		x_test_active = 1;
+		in_motion     = 1;
+		motion1D_timer1_enable();
+		while (int_active) yield();
+		x_test_active = 0;
+		in_motion     = 0;
+	}
+#ifdef USE_RAMP
+	x_ramp_enabled = 1;
+#endif
+	r->late         = x_test_late;
+	r->max_interval = x_test_dmax / CCOUNT_PER_CLOCK;
+	r->max_isr      = x_test_isr_max / CCOUNT_PER_CLOCK;
+	return true;
+}
+//====================================================================================
+
+#ifdef MOTION_QUEUE_SIZE
+/*!
+ * \brief Execute next entry from the motion queue.
+ */
+void Motion1D::motionQ_pull()
+{
+	int pos = m_motionQRd;
+	motion_queue_t *v = &m_motionQ[pos];
+
+	if (m_moveSplit) {
+		/* Next piece of the move */
+		movePiece();
+		if (m_moveSplit) return;
+	}
+	if (m_home != HOME_OFF) {
+		/* Next pass of the homing cycle */
+		homeNext();
+		if (m_home != HOME_OFF) return;
+	}
+	if (encoderCorrect()) return;
+	if (m_motionQWr == m_motionQRd) return;
+	/* Moves are checked by the encoder when they end */
+	m_encCheck = (v->cmd == MOTION_CMD_GOTO) || (v->cmd == MOTION_CMD_MOVE) || (v->cmd == MOTION_CMD_CURVE) || (v->cmd == MOTION_CMD_MAP);
+	switch (v->cmd) {
+		case MOTION_CMD_GOTO: moveStart(x_target + v->x, (planner_duration_period(v->duration, v->x >> v->arg) << 8) >> v->arg); break;
+		case MOTION_CMD_MOVE: moveStart(x_target + v->x, (uint64_t)v->duration << (9 - v->arg)); break;
+		case MOTION_CMD_CURVE: curveStart(v->duration, v->x, v->arg >> 16, v->arg & 0xffff); break;
+		case MOTION_CMD_MAP: mapStart(v->x); break;
+		case MOTION_CMD_DWELL: dwellStart(v->duration); break;
+		case MOTION_CMD_HOME: {
+			homeStart(v->x, v->duration);
+			/* Queue flushed by a failed homing */
+			if (m_motionQWr == m_motionQRd) return;
+		} break;
+		case MOTION_CMD_LOOP: {
+			if (v->x == 0) {
+				/* Wait until the whole body is queued (cancel when it does not fit into the queue) */
+				if (!motionQ_is_full()) return;
+				v->cmd = MOTION_CMD_NOP;
+				break;
+			}
+			m_loopBegin[m_loopLevel] = pos;
+			m_loopCount[m_loopLevel] = v->duration;
+			m_loopLevel++;
+		} break;
+		case MOTION_CMD_ENDL: {
+			if (m_loopLevel == 0) break;
+			if ((m_loopCount[m_loopLevel - 1] == 0) || (--m_loopCount[m_loopLevel - 1] > 0)) {
+				/* Next iteration */
+				pos = m_loopBegin[m_loopLevel - 1];
+			} else {
+				m_loopLevel--;
+			}
+		} break;
+		default: break;
+	}
+	pos++;
+	pos &= MOTION_QUEUE_MASK;
+	m_motionQRd = pos;
+}
+//====================================================================================
+
+/*!
+ * \brief Queue loop begin (count - number of iterations, 0 - forever).
+ * Loop is started when the matching loop end is queued (whole body must fit into the queue).
+ */
+boolean Motion1D::loopBegin(int count)
+{
+	if (m_loopOpenN >= MOTION_LOOP_DEPTH) return false;
+	m_loopOpen[m_loopOpenN++] = m_motionQWr;
+	motionQ_push(MOTION_CMD_LOOP, count, 0);
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Queue loop end.
+ * \return false when there is no open loop or the loop was cancelled (body too large).
+ */
+boolean Motion1D::loopEnd()
+{
+	motion_queue_t *v;
+
+	if (m_loopOpenN == 0) return false;
+	v = &m_motionQ[m_loopOpen[--m_loopOpenN]];
+	if (v->cmd != MOTION_CMD_LOOP) return false;
+	motionQ_push(MOTION_CMD_ENDL, 0, 0);
+	v->x = 1;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Cancel last open loop (body is executed once).
+ */
+void Motion1D::loopCancel()
+{
+	if (m_loopOpenN == 0) return;
+	m_motionQ[m_loopOpen[--m_loopOpenN]].cmd = MOTION_CMD_NOP;
+}
+//====================================================================================
+#endif
+
+/*!
+ * \brief Clear position-indexed speed map.
+ */
+void Motion1D::mapClear()
+{
+	map_n = 0;
+}
+//====================================================================================
+
+/*!
+ * \brief Speed map has no knots.
+ */
+boolean Motion1D::mapEmpty()
+{
+	return (map_n == 0);
+}
+//====================================================================================
+
+/*!
+ * \brief Speed map - knot half periods and per step increments between knots at the resolution
+ * of the move (1/256 microsteps per STEP = 1 << shift).
+ */
+static void mapSlopes(int shift)
+{
+	int n;
+
+	for (int i = 0; i < map_n; ++i) map_h[i] = planner_hperiod(((uint64_t)PLANNER_CLOCK << shift) / map_v[i]);
+	for (int i = 0; i < map_n; ++i) {
+		map_dh[i] = 0;
+		if (i < (map_n - 1)) {
+			n = (map_pos[i + 1] - map_pos[i]) >> shift;
+			if (n == 0) n = 1;
+			map_dh[i] = (((int64_t)map_h[i + 1] - (int64_t)map_h[i]) << 32) / n;
+		}
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Add (position, speed) knot to the speed map (kept sorted by position), both in 1/256 microsteps,
+ * so knots do not depend on the resolution they were set with or the resolution of the move.
+ * \return false when map is full, speed is not positive or knot position is already used.
+ */
+boolean Motion1D::mapAdd(int pos, int speed)
+{
+	int i, j;
+
+	if ((map_n >= SPEED_MAP_SIZE) || (speed <= 0)) return false;
+	for (i = 0; (i < map_n) && (map_pos[i] < pos); ++i);
+	if ((i < map_n) && (map_pos[i] == pos)) return false;
+	for (j = map_n; j > i; --j) {
+		map_pos[j] = map_pos[j - 1];
+		map_v[j]   = map_v[j - 1];
+	}
+	map_pos[i] = pos;
+	map_v[i]   = speed;
+	map_n++;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Start move (dx in 1/256 microsteps) with speed interpolated from the map at every step (in the ISR).
+ */
+void Motion1D::mapStart(int dx)
+{
+#ifdef USE_RAMP
+	int     x = x_target, i, s = segmentShift(dx);
+	int64_t hq;
+
+	if (in_motion) { return; }
+	setResolution(s);
+	if (map_n == 0) {
+		/* Map cleared meanwhile - do not lose the move, run it at start/stop speed */
+		startMove(dx, RSTART_STOP_HPERIOD);
+		return;
+	}
+	mapSlopes(s);
+	/* Find segment and interpolate start speed */
+	if (dx > 0) {
+		for (i = map_n - 1; (i >= 0) && (map_pos[i] > x); --i);
+	} else {
+		for (i = map_n - 1; (i >= 0) && (map_pos[i] >= x); --i);
+	}
+	if (i < 0) {
+		hq = (int64_t)map_h[0] << 32;
+	} else if (i == (map_n - 1)) {
+		hq = (int64_t)map_h[i] << 32;
+	} else {
+		hq = ((int64_t)map_h[i] << 32) + map_dh[i] * ((x - map_pos[i]) >> s);
+	}
+	x_map_dir   = (dx > 0);
+	x_map_idx   = i;
+	x_map_hq    = hq;
+	x_map_hmin  = planner_hperiod(0);
+	x_map_scale = ((uint32_t)100 << 16) / m_override;
+	startMove(dx, hq >> 32, true);
+#else
+	setResolution(segmentShift(dx));
+	startMove(dx, (map_n) ? planner_hperiod(((uint64_t)PLANNER_CLOCK << x_shift) / map_v[0]) : planner_hperiod(160000));
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Start curve segment (cubic Bezier easing in time), dx in 1/256 microsteps.
+ * Position is interpolated every CURVE_TICK_US in the main loop, the ISR runs without ramp.
+ */
+void Motion1D::curveStart(int duration, int dx, int p1, int p2)
+{
+	if (in_motion) { return; }
+	if (!m_motorsEnabled) {motorsOn();}
+	motion1D_timer1_disable();
+	if (duration == 0) duration = 100;
+	setResolution(segmentShift(dx));
+	m_curveX0       = x_target;
+	m_curveDelta    = dx;
+	m_curveP1       = planner_curve_ordinate(p1);
+	m_curveP2       = planner_curve_ordinate(p2);
+	m_curveT        = 0;
+	m_curveDuration = (uint64_t)duration * 1000;
+	m_curveLast     = micros();
+	m_curveNext     = m_curveLast;
+	m_curveActive   = 1;
+	x_pulse         = 0;
+	if (dx > 0) digitalWrite(m_x_dir, HIGH); else digitalWrite(m_x_dir, LOW);
+#ifdef USE_RAMP
+	x_ramp_enabled  = 0;
+#endif
+	in_motion       = 1;
+	curveLoop();
+}
+//====================================================================================
+
+/*!
+ * \brief Curve interpolation tick - set next target and speed of the step generator.
+ */
+void Motion1D::curveLoop()
+{
+	uint32_t now = micros();
+	uint64_t t;
+	int      xn, steps;
+
+	if ((int32_t)(now - m_curveNext) < 0) return;
+	if (m_resWait) {
+		/* Curve time starts when the driver resolution is set */
+		m_curveLast = now;
+		return;
+	}
+	m_curveT   += ((uint64_t)(now - m_curveLast) * m_override) / 100;
+	m_curveLast = now;
+	m_curveNext = now + CURVE_TICK_US;
+	if (m_curveT >= m_curveDuration) {
+		/* Wait for the last steps (a late tick may have skipped the end point - go there first) */
+		if (x_target == m_curveX0 + m_curveDelta) {
+			if (int_active == 0) m_curveActive = 0;
+			return;
+		}
+		t = m_curveDuration;
+	} else {
+		t = m_curveT + (CURVE_TICK_US * m_override) / 100;
+		if (t > m_curveDuration) t = m_curveDuration;
+	}
+	xn    = m_curveX0 + (((int)(((int64_t)m_curveDelta * planner_curve((t << 16) / m_curveDuration, m_curveP1, m_curveP2)) >> 16) >> x_shift) << x_shift);
+	if (t == m_curveDuration) xn = m_curveX0 + m_curveDelta;
+	steps = xn - x_pos;
+	if (steps < 0) steps = -steps;
+	steps >>= x_shift;
+	if (steps == 0) {
+		if (x_target == xn) return;
+		steps = 1;
+	}
+	noInterrupts();
+	x_target  = xn;
+	x_hperiod = planner_hperiod(((uint64_t)CURVE_TICK_US * 80) / steps);
+	RTC_REG_WRITE(FRC1_LOAD_ADDRESS, x_hperiod);
+	interrupts();
+	if (int_active == 0) motion1D_timer1_enable();
+}
+//====================================================================================
+
+/*!
+ * \brief Leave curve interpolation - continue at the current speed with the ramp enabled (used to brake).
+ */
+void Motion1D::curveToRamp()
+{
+	if (!m_curveActive) return;
+	m_curveActive = 0;
+#ifdef USE_RAMP
+	uint32_t h = x_hperiod;
+	/* Braking distance from the current speed */
+	int      b = planner_brake_steps(h);
+	noInterrupts();
+	x_target_hperiod = h;
+	x_ramp_iter      = 0;
+	x_brake          = b;
+	x_ramp_enabled   = 1;
+	interrupts();
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Executed in main loop.
+ */
+boolean Motion1D::loop()
+{
+	encoderMonitor();
+	if (m_startWait) {
+		/* Prepared move waits for the driver resolution change */
+		if (m_resWait) return true;
+		m_startWait = 0;
+		motion1D_timer1_enable();
+	}
+	if ((m_hybrid != HYBRID_OFF) && (hybridLoop())) {
+#ifdef MOTION_QUEUE_SIZE
+		return motionQ_is_full();
+#else
+		return true;
+#endif
+	}
+	if (m_jogActive) {
+		if (int_active == 0) {
+			/* Stopped - restart when requested speed changed direction */
+			in_motion   = 0;
+			m_jogActive = 0;
+			if ((m_jogSpeed) && ((int32_t)(m_jogDeadline - millis()) > 0) && (m_jogLimit != x_pos)) {
+				jog(m_jogSpeed, m_jogLimit, m_jogDeadline - millis());
+			}
+		} else if ((m_jogSpeed) && ((int32_t)(m_jogDeadline - millis()) <= 0)) {
+			/* Dead-man timeout */
+			m_jogSpeed = 0;
+			brake();
+		}
+		return true;
+	}
+#ifdef MOTION_QUEUE_SIZE
+	if (m_paused) {
+		/* Hold the queue */
+		return motionQ_is_full();
+	}
+	if (m_curveActive) {
+		curveLoop();
+		return motionQ_is_full();
+	}
+	if (in_motion) {
+		if (int_active == 0) {
+			in_motion = 0;
+			motionQ_pull();
+		}
+	} else {
+		motionQ_pull();
+	}
+	return motionQ_is_full();
+#else
+	if (in_motion) {
+		if (int_active == 0) {
+			in_motion = 0;
+		}
+	}
+	return in_motion;
+#endif
+}
+//====================================================================================
+
+/*!
+ * \brief Check in motion flag.
+ */
+boolean Motion1D::isInMotion()
+{
+	if (in_motion) return true;
+	if (m_hybrid != HYBRID_OFF) return true;
+	if (m_home != HOME_OFF) return true;
+	if ((m_moveSplit) && (x_target != m_moveEnd)) return true;
+	if (m_paused) return true;
+#ifdef MOTION_QUEUE_SIZE
+	if (m_motionQWr  != m_motionQRd) return true;
+#endif	
+	return false;
+}
+//====================================================================================
+
+// Speed critical bits
+#pragma GCC optimize ("O2")
+// Normally would not want two copies like this, but due to different
+// optimization levels the inline attribute gets lost if we try the
+// other version.
+
+//static inline ICACHE_RAM_ATTR uint32_t GetCycleCountIRQ()
+//{
+//	uint32_t ccount;
+//	__asm__ __volatile__("rsr %0,ccount":"=a"(ccount));
+//	return ccount;
+//}
+//===========================================================================================
+
+#ifdef USE_RAMP
+/*!
+ * \brief Speed map - interpolate target half period for the current position (once per step).
+ */
+static inline ICACHE_RAM_ATTR void motion_map(void)
+{
+	int      i = x_map_idx;
+	uint32_t h;
+
+	if (x_map_dir) {
+		/* Segment i: [map_pos[i], map_pos[i+1]) */
+		if ((i < (map_n - 1)) && (x_pos >= map_pos[i + 1])) {
+			i++;
+			x_map_idx = i;
+			x_map_hq  = (int64_t)map_h[i] << 32;
+		} else if ((i >= 0) && (i < (map_n - 1))) {
+			x_map_hq += map_dh[i];
+		}
+	} else {
+		/* Segment i: (map_pos[i], map_pos[i+1]] */
+		if ((i >= 0) && (x_pos <= map_pos[i])) {
+			x_map_hq  = (int64_t)map_h[i] << 32;
+			x_map_idx = i - 1;
+		} else if ((i >= 0) && (i < (map_n - 1))) {
+			x_map_hq -= map_dh[i];
+		}
+	}
+	/* Feed-rate override like the other moves */
+	h = (uint32_t)(((x_map_hq >> 32) * x_map_scale) >> 16);
+	x_target_hperiod = (h < x_map_hmin) ? x_map_hmin : h;
+}
+//===========================================================================================
+
+/*!
+ * \brief Tabled ramp - track target half period (both directions) and brake before target.
+ * Executed once per step (after STEP pulse), the ramp itself is shared with the planner.
+ */
+static inline ICACHE_RAM_ATTR void motion_ramp(void)
+{
+	int      remaining = x_target - x_pos;
+	uint32_t h         = x_hperiod;
+	int      iter      = x_ramp_iter;
+	int      brake     = x_brake;
+
+	if (remaining < 0) remaining = -remaining;
+	remaining >>= x_shift;
+	if (planner_ramp_step(&h, x_target_hperiod, &iter, &brake, remaining)) {
+		x_hperiod = h;
+		RTC_REG_WRITE(FRC1_LOAD_ADDRESS, h);
+	}
+	x_ramp_iter = iter;
+	x_brake     = brake;
+}
+#endif
+
+/*!
+ * \brief timer1 interrupt handler.
+ */
+void ICACHE_RAM_ATTR motion_intr_handler(void)
+{
+	uint32_t t0 = 0, d;
+
+	/* Clear interrupt mask */
+	timer->frc1_int &= ~FRC1_INT_CLR_MASK;
+	if (x_test_active) {
+		/* Step rate self-test - interval longer than 1.5 half period means a missed timer edge */
+		t0 = GetCycleCount();
+		if (x_test_last) {
+			d = t0 - x_test_last;
+			if (d > x_test_dmax) x_test_dmax = d;
+			if (d > ((x_hperiod + (x_hperiod >> 1)) * CCOUNT_PER_CLOCK)) x_test_late++;
+		}
+		x_test_last = t0;
+	}
+	if (x_pulse) {
+		asm volatile ("" : : : "memory");
+		gpio_r->out_w1tc = (uint32_t)(x_gpio_mask);
+		x_pulse = 0;
+		if (x_pos == x_target) {
+			/* We are in target position :-) - disable timer */
+			timer->frc1_int &= ~FRC1_INT_CLR_MASK;
+			timer->frc1_ctrl = 0;
+			int_active = 0;
+		}
+#ifdef USE_RAMP
+		else if (x_ramp_enabled) {
+			if (x_map_active) motion_map();
+			motion_ramp();
+		}
+#endif
+	} else if (x_pos != x_target) {
+		asm volatile ("" : : : "memory");
+		gpio_r->out_w1ts = (uint32_t)(x_gpio_mask);
+		x_pulse = 1;
+		if (x_pos > x_target) x_pos -= (1 << x_shift); else x_pos += (1 << x_shift);
+	} else if (x_dwell > 1) {
+		/* Dwell - only count timer ticks, the last one ends it (n ticks - n ms) */
+		x_dwell--;
+	} else {
+		/* We are in target position :-) - disable timer */
+		x_dwell = 0;
+		timer->frc1_int &= ~FRC1_INT_CLR_MASK;
+		timer->frc1_ctrl = 0;
+		int_active = 0;
+	}
+	if (t0) {
+		d = GetCycleCount() - t0;
+		if (d > x_test_isr_max) x_test_isr_max = d;
 	}
 }
 //===========================================================================================
@@ -0,0 +1,506 @@
+/*
+ * Asynchronous TMC2208 single wire UART register access.
+ *
+ * Author: Rafal Vonau <rafal.vonau@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ */
+#include "TMC2208Uart.h"
+
+/* Shadowed configuration registers (write only registers are never compared with the chip) */
+static const struct {
+	uint8_t  reg;
+	uint8_t  readable;
+	uint32_t reset;
+} tmc_shadow_regs[TMC_SHADOW_N] = {
+	{TMC_GCONF,      1, 0x00000101},
+	{TMC_IHOLD_IRUN, 0, 0x00011F08},
+	{TMC_TPOWERDOWN, 0, 20},
+	{TMC_TPWMTHRS,   0, 0},
+	{TMC_CHOPCONF,   1, 0x10000053},
+	{TMC_PWMCONF,    1, 0xC10D0024},
+#ifdef DRIVER_TMC2209
+	{TMC_TCOOLTHRS,  0, 0},
+	{TMC_SGTHRS,     0, 0},
+#endif
+};
+
+TMC2208Uart::TMC2208Uart(Stream *serial, float rsense, uint8_t addr)
+{
+	m_serial    = serial;
+	m_rsense    = rsense;
+	m_addr      = addr;
+	m_rd        = 0;
+	m_wr        = 0;
+	m_state     = TMC_STATE_IDLE;
+	m_reading   = 0;
+	m_value     = 0;
+	m_retry     = 0;
+	m_t0        = 0;
+	m_txTime    = 0;
+	m_rxN       = 0;
+	m_reads     = 0;
+	m_writes    = 0;
+	m_crcErrors = 0;
+	m_timeouts  = 0;
+	m_failed    = 0;
+	for (int i = 0; i < TMC_SHADOW_N; ++i) {
+		m_shadow[i]  = tmc_shadow_regs[i].reset;
+		m_touched[i] = 0;
+	}
+	m_dirty     = 0;
+	m_busy      = 0;
+	m_loading   = 0;
+	m_checkT    = 0;
+	m_checkIdx  = 0;
+	m_mismatch  = 0;
+	m_resets    = 0;
+	m_holdPercent = TMC_HOLD_PERCENT;
+}
+//====================================================================================
+
+/*!
+ * \brief Datagram CRC (polynomial x^8 + x^2 + x + 1, bytes sent LSB first).
+ */
+uint8_t TMC2208Uart::crc8(const uint8_t *data, int len)
+{
+	uint8_t crc = 0, b;
+	int     i, j;
+
+	for (i = 0; i < len; ++i) {
+		b = data[i];
+		for (j = 0; j < 8; ++j) {
+			if ((crc >> 7) ^ (b & 0x01)) crc = (crc << 1) ^ 0x07; else crc = (crc << 1);
+			b >>= 1;
+		}
+	}
+	return crc;
+}
+//====================================================================================
+
+/*!
+ * \brief CHOPCONF MRES field for microsteps per step (256 - 0 ... 1 - 8).
+ */
+uint32_t TMC2208Uart::mres(uint16_t ms)
+{
+	uint32_t m = 8;
+
+	while ((m > 0) && ((256u >> m) < ms)) m--;
+	return m;
+}
+//====================================================================================
+
+/*!
+ * \brief Queue transaction, return false when the queue is full.
+ */
+bool TMC2208Uart::push(uint8_t op, uint8_t reg, uint32_t value, uint32_t mask, TMCDoneCB cb)
+{
+	int pos = (m_wr + 1) & TMC_QUEUE_MASK;
+	tmc_transaction_t *t = &m_q[m_wr];
+
+	if (pos == m_rd) return false;
+	t->op    = op;
+	t->reg   = reg;
+	t->value = value;
+	t->mask  = mask;
+	t->cb    = cb;
+	m_wr     = pos;
+	return true;
+}
+//====================================================================================
+
+/*!
+ * \brief Queue register read (cb is called with the CRC checked value).
+ */
+bool TMC2208Uart::read(uint8_t reg, TMCDoneCB cb)
+{
+	return push(TMC_OP_READ, reg, 0, 0, cb);
+}
+//====================================================================================
+
+/*!
+ * \brief Queue register write.
+ */
+bool TMC2208Uart::write(uint8_t reg, uint32_t value, TMCDoneCB cb)
+{
+	return push(TMC_OP_WRITE, reg, value, 0xffffffff, cb);
+}
+//====================================================================================
+
+/*!
+ * \brief Queue read-modify-write of the masked bits.
+ */
+bool TMC2208Uart::modify(uint8_t reg, uint32_t mask, uint32_t value, TMCDoneCB cb)
+{
+	return push(TMC_OP_MODIFY, reg, value, mask, cb);
+}
+//====================================================================================
+
+/*!
+ * \brief Shadow index of the register (-1 - not shadowed).
+ */
+int TMC2208Uart::shadowIndex(uint8_t reg)
+{
+	for (int i = 0; i < TMC_SHADOW_N; ++i) {
+		if (tmc_shadow_regs[i].reg == reg) return i;
+	}
+	return -1;
+}
+//====================================================================================
+
+/*!
+ * \brief Load shadow from the chip (readable registers) and clear the reset flag.
+ * Fields set before the registers are read are kept, the shadow is written after loading.
+ */
+void TMC2208Uart::begin()
+{
+	for (int i = 0; i < TMC_SHADOW_N; ++i) {
+		if (!tmc_shadow_regs[i].readable) continue;
+		m_loading |= (1u << i);
+		read(tmc_shadow_regs[i].reg, [this, i](bool ok, uint32_t v) {shadowLoaded(i, ok, v);});
+	}
+	write(TMC_GSTAT, GSTAT_RESET);
+}
+//====================================================================================
+
+/*!
+ * \brief Shadow register read at startup (reset value is used when the driver does not respond).
+ */
+void TMC2208Uart::shadowLoaded(int i, bool ok, uint32_t v)
+{
+	if (ok) m_shadow[i] = (v & ~m_touched[i]) | (m_shadow[i] & m_touched[i]);
+	m_loading &= ~(1u << i);
+}
+//====================================================================================
+
+/*!
+ * \brief Set masked bits of a configuration register.
+ * Only the shadow is changed here, changed registers are written (one datagram per register)
+ * by the next loop(), cb is called when the value is in the chip.
+ */
+void TMC2208Uart::set(uint8_t reg, uint32_t mask, uint32_t value, TMCDoneCB cb)
+{
+	int      i = shadowIndex(reg);
+	uint32_t b, v;
+
+	if (i < 0) {
+		modify(reg, mask, value, cb);
+		return;
+	}
+	b = 1u << i;
+	v = (m_shadow[i] & ~mask) | (value & mask);
+	m_touched[i] |= mask;
+	if ((v == m_shadow[i]) && (!m_loading) && (!((m_dirty | m_busy) & b))) {
+		/* Already in the chip */
+		if (cb) cb(true, v);
+		return;
+	}
+	m_shadow[i] = v;
+	m_dirty    |= b;
+	if (!cb) return;
+	if (m_shadowCb[i]) {
+		TMCDoneCB prev = m_shadowCb[i];
+		m_shadowCb[i] = [prev, cb](bool ok, uint32_t v) {prev(ok, v); cb(ok, v);};
+	} else {
+		m_shadowCb[i] = cb;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Shadow value of the register (0 - not shadowed).
+ */
+uint32_t TMC2208Uart::get(uint8_t reg)
+{
+	int i = shadowIndex(reg);
+
+	return (i < 0) ? 0 : m_shadow[i];
+}
+//====================================================================================
+
+/*!
+ * \brief Queue writes of the changed shadow registers.
+ */
+void TMC2208Uart::shadowFlush()
+{
+	for (int i = 0; i < TMC_SHADOW_N; ++i) {
+		uint32_t  b  = 1u << i;
+		TMCDoneCB cb = m_shadowCb[i];
+
+		if (!(m_dirty & b)) continue;
+		if (!write(tmc_shadow_regs[i].reg, m_shadow[i], [this, b, cb](bool ok, uint32_t v) {
+			m_busy &= ~b;
+			if (cb) cb(ok, v);
+		})) return;
+		m_dirty      &= ~b;
+		m_busy       |= b;
+		m_shadowCb[i] = NULL;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Integrity check - detect driver reset (brown-out) and compare one readable register
+ * with the shadow, differing registers are written again.
+ */
+void TMC2208Uart::shadowCheck()
+{
+	int i;
+
+	m_checkT = millis();
+	read(TMC_GSTAT, [this](bool ok, uint32_t v) {
+		if ((!ok) || (!(v & GSTAT_RESET))) return;
+		m_resets++;
+		write(TMC_GSTAT, GSTAT_RESET);
+		m_dirty = (1u << TMC_SHADOW_N) - 1;
+	});
+	for (i = m_checkIdx; !tmc_shadow_regs[i].readable; i = (i + 1) % TMC_SHADOW_N);
+	m_checkIdx = (i + 1) % TMC_SHADOW_N;
+	read(tmc_shadow_regs[i].reg, [this, i](bool ok, uint32_t v) {
+		if ((!ok) || ((m_dirty | m_busy) & (1u << i)) || (v == m_shadow[i])) return;
+		m_mismatch++;
+		m_dirty |= (1u << i);
+	});
+}
+//====================================================================================
+
+/*!
+ * \brief Set motor RMS current in [mA] (hold current is m_holdPercent of the run current).
+ * Current scale is computed as in the TMCStepper library, the low sense range (vsense)
+ * is used for small currents.
+ */
+void TMC2208Uart::rmsCurrent(uint16_t mA, TMCDoneCB cb)
+{
+	float   k  = 32.0 * 1.41421 * mA / 1000.0 * (m_rsense + 0.02);
+	int     cs = k / 0.325 - 1;
+	uint32_t v = 0;
+
+	if (cs < 16) {
+		v  = CHOPCONF_VSENSE;
+		cs = k / 0.180 - 1;
+	}
+	if (cs > 31) cs = 31;
+	if (cs < 0) cs = 0;
+	set(TMC_CHOPCONF, CHOPCONF_VSENSE, v);
+	set(TMC_IHOLD_IRUN, IHOLD_MASK | IRUN_MASK, IHOLD_IRUN((cs * m_holdPercent) / 100, cs, 0), cb);
+}
+//====================================================================================
+
+/*!
+ * \brief Set microsteps per step (power of 2, 1..256).
+ */
+void TMC2208Uart::microsteps(uint16_t ms, TMCDoneCB cb)
+{
+	set(TMC_CHOPCONF, CHOPCONF_MRES_MASK, mres(ms) << CHOPCONF_MRES_SHIFT, cb);
+}
+//====================================================================================
+
+/*!
+ * \brief StealthChop up to speed, SpreadCycle above.
+ * The chip compares TSTEP (time between 1/256 microsteps) with TPWMTHRS after every step,
+ * so the threshold does not depend on the microstep resolution.
+ * \param speed - threshold in [1/256 microsteps/s], 0 - StealthChop at all speeds, < 0 - SpreadCycle only.
+ */
+void TMC2208Uart::stealthChop(int speed, TMCDoneCB cb)
+{
+	uint32_t t = 0;
+
+	if (speed > 0) {
+		t = TMC_FCLK / speed;
+		if (t > TPWMTHRS_MAX) t = TPWMTHRS_MAX;
+		if (t < 1) t = 1;
+	}
+	set(TMC_GCONF, GCONF_EN_SPREADCYCLE, (speed < 0) ? GCONF_EN_SPREADCYCLE : 0);
+	set(TMC_TPWMTHRS, TPWMTHRS_MAX, t, cb);
+}
+//====================================================================================
+
+/*!
+ * \brief Standstill current reduction - the chip drops to the hold current when no step came
+ * for settleMs and returns to the run current on the next step (no UART traffic per move).
+ * \param percent  - hold current in [%] of the run current,
+ * \param settleMs - standstill time in [ms] (TPOWERDOWN, 2^18 clocks per unit, 44ms .. 5.5s).
+ */
+void TMC2208Uart::holdCurrent(int percent, int settleMs, TMCDoneCB cb)
+{
+	uint32_t irun = (get(TMC_IHOLD_IRUN) & IRUN_MASK) >> 8;
+	int      t    = ((int64_t)settleMs * (TMC_FCLK / 1000)) >> 18;
+
+	if (percent > 100) percent = 100;
+	if (percent < 0) percent = 0;
+	if (t > 255) t = 255;
+	if (t < 2) t = 2;
+	m_holdPercent = percent;
+	set(TMC_TPOWERDOWN, 0xFF, t);
+	set(TMC_IHOLD_IRUN, IHOLD_MASK | IHOLDDELAY_MASK, IHOLD_IRUN((irun * percent) / 100, 0, TMC_IHOLDDELAY), cb);
+}
+//====================================================================================
+
+#ifdef DRIVER_TMC2209
+/*!
+ * \brief StallGuard4 (StealthChop only) - DIAG goes high when SG_RESULT <= 2 * threshold
+ * while the motor runs faster than speed.
+ * \param threshold - SGTHRS (0..255, higher - more sensitive), 0 - DIAG disabled,
+ * \param speed     - minimum speed in [1/256 microsteps/s] (TCOOLTHRS, StallGuard is not reliable below).
+ */
+void TMC2208Uart::stallGuard(int threshold, int speed, TMCDoneCB cb)
+{
+	uint32_t t = 0;
+
+	if (threshold > 255) threshold = 255;
+	if ((threshold > 0) && (speed > 0)) {
+		t = TMC_FCLK / speed;
+		if (t > TPWMTHRS_MAX) t = TPWMTHRS_MAX;
+	}
+	set(TMC_SGTHRS, 0xFF, (threshold > 0) ? threshold : 0);
+	set(TMC_TCOOLTHRS, TPWMTHRS_MAX, t, cb);
+}
+//====================================================================================
+#endif
+
+/*!
+ * \brief Send datagram of the running transaction (read request or write).
+ */
+void TMC2208Uart::start()
+{
+	tmc_transaction_t *t = &m_q[m_rd];
+	uint8_t b[8];
+	int     n;
+
+	/* Drop echo and noise of the previous transaction */
+	while (m_serial->available()) m_serial->read();
+	b[0] = TMC_SYNC;
+	b[1] = m_addr;
+	if (m_reading) {
+		b[2] = t->reg;
+		n    = 3;
+	} else {
+		b[2] = t->reg | TMC_WRITE;
+		b[3] = m_value >> 24;
+		b[4] = m_value >> 16;
+		b[5] = m_value >> 8;
+		b[6] = m_value;
+		n    = 7;
+	}
+	b[n] = crc8(b, n);
+	n++;
+	/* Fits into the hardware TX FIFO - does not block */
+	m_serial->write(b, n);
+	m_t0     = micros();
+	m_txTime = (n * 10 * 1000000) / TMC_BAUD + 1;
+	m_rxN    = 0;
+	m_state  = (m_reading) ? TMC_STATE_REPLY : TMC_STATE_SEND;
+}
+//====================================================================================
+
+/*!
+ * \brief Phase of the running transaction done.
+ */
+void TMC2208Uart::done(bool ok, uint32_t value)
+{
+	tmc_transaction_t *t = &m_q[m_rd];
+	TMCDoneCB cb;
+
+	if ((ok) && (m_reading) && (t->op == TMC_OP_MODIFY)) {
+		/* Write back modified value */
+		m_value   = (value & ~t->mask) | (t->value & t->mask);
+		m_reading = 0;
+		m_retry   = 0;
+		start();
+		return;
+	}
+	if (ok) {
+		if (m_reading) m_reads++; else m_writes++;
+	}
+	if (!m_reading) value = m_value;
+	cb      = t->cb;
+	t->cb   = NULL;
+	m_rd    = (m_rd + 1) & TMC_QUEUE_MASK;
+	m_state = TMC_STATE_IDLE;
+	if (cb) cb(ok, value);
+}
+//====================================================================================
+
+/*!
+ * \brief Phase of the running transaction failed - retry or give up.
+ */
+void TMC2208Uart::fail()
+{
+	if (m_retry < TMC_RETRIES) {
+		m_retry++;
+		start();
+		return;
+	}
+	m_failed++;
+	done(false, 0);
+}
+//====================================================================================
+
+/*!
+ * \brief Transaction state machine - executed in main loop, never waits for the UART.
+ */
+void TMC2208Uart::loop()
+{
+	tmc_transaction_t *t;
+	uint32_t v;
+
+	if ((m_dirty) && (!m_loading)) shadowFlush();
+	if ((idle()) && (!m_dirty) && (!m_loading) && ((millis() - m_checkT) >= TMC_CHECK_MS)) shadowCheck();
+	if (m_state == TMC_STATE_IDLE) {
+		if (m_rd == m_wr) return;
+		t         = &m_q[m_rd];
+		m_reading = (t->op != TMC_OP_WRITE);
+		m_value   = t->value;
+		m_retry   = 0;
+		start();
+	}
+	if (m_state == TMC_STATE_SEND) {
+		/* Write datagram is not acknowledged - done when transmitted */
+		if ((micros() - m_t0) < m_txTime) return;
+		done(true, 0);
+		return;
+	}
+	/* Collect reply - sliding window skips the echo of the request (address != master address) */
+	t = &m_q[m_rd];
+	while (m_serial->available()) {
+		if (m_rxN == 8) {
+			memmove(m_rx, m_rx + 1, 7);
+			m_rxN = 7;
+		}
+		m_rx[m_rxN++] = m_serial->read();
+		if ((m_rxN == 8) && (m_rx[0] == TMC_SYNC) && (m_rx[1] == TMC_MASTER_ADDR) && (m_rx[2] == t->reg)) {
+			if (crc8(m_rx, 7) != m_rx[7]) {
+				m_crcErrors++;
+				fail();
+				return;
+			}
+			v = ((uint32_t)m_rx[3] << 24) | ((uint32_t)m_rx[4] << 16) | ((uint32_t)m_rx[5] << 8) | m_rx[6];
+			done(true, v);
+			return;
+		}
+	}
+	if ((micros() - m_t0) > (m_txTime + TMC_TIMEOUT_US)) {
+		m_timeouts++;
+		fail();
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Print UART statistics.
+ */
+void TMC2208Uart::printStat(CommandQueueItem *c)
+{
+	c->print("reads="+String(m_reads)+"\r\nwrites="+String(m_writes)+"\r\ncrc_errors="+String(m_crcErrors)+"\r\n" \
+		"timeouts="+String(m_timeouts)+"\r\nfailed="+String(m_failed)+"\r\nqueued="+String((m_wr - m_rd) & TMC_QUEUE_MASK)+"\r\n" \
+		"shadow_mismatch="+String(m_mismatch)+"\r\ndriver_resets="+String(m_resets)+"\r\n" \
+		"gconf=0x"+String(m_shadow[0], HEX)+"\r\nchopconf=0x"+String(get(TMC_CHOPCONF), HEX)+"\r\n" \
+		"ihold_irun=0x"+String(get(TMC_IHOLD_IRUN), HEX)+"\r\ntpowerdown="+String(get(TMC_TPOWERDOWN))+"\r\npwmconf=0x"+String(get(TMC_PWMCONF), HEX)+"\r\n");
+#ifdef DRIVER_TMC2209
+	c->print("sgthrs="+String(get(TMC_SGTHRS))+"\r\ntcoolthrs="+String(get(TMC_TCOOLTHRS))+"\r\n");
+#endif
+	c->print("OK\r\n");
+}
+//====================================================================================
@@ -6,9 +6,10 @@ extern "C" {
 #include <ArduinoOTA.h>
 #include <DNSServer.h>
 #include "Motion1D.h"
-#include <TMCStepper.h>
+#include "TMC2208Uart.h"
 #include "NetworkCommand.h"
 #include "HTTPCommand.h"
+#include "FileCommand.h"
 #include "UdpLogger.h"
 
 /* SWITCHES */
@@ -16,16 +17,38 @@ extern "C" {
 #define NPORT                    (2500)
 
 #define MAX_DIST_MOTTOR (45)
+#define MAX_POS         (MAX_DIST_MOTTOR * 200 * MICROSTEP_FINE)   /*!< Soft limit in 1/256 microsteps. */
+#define JOG_TIMEOUT     (500)
+#ifdef DRIVER_TMC2209
+#define STEALTH_RPM     (0)             /*!< StealthChop at all speeds (StallGuard4 works in StealthChop only). */
+#define STALL_THRESHOLD (80)            /*!< Default SGTHRS (stall when SG_RESULT <= 2 * SGTHRS). */
+#define STALL_MIN_RPM   (30)            /*!< StallGuard is enabled above this speed [rev/min].   */
+#else
+#define STEALTH_RPM     (100)           /*!< StealthChop up to this speed [rev/min], SpreadCycle above. */
+#endif
+#define HOME_RPM        (100)           /*!< Homing approach and back-off speed [rev/min] (does not depend on S). */
+#if defined(DRIVER_TMC2209) && (HOME_RPM < 2 * STALL_MIN_RPM)
+#error "Sensorless homing needs HOME_RPM well above STALL_MIN_RPM"
+#endif
+#define HOLD_SETTLE_MS  (500)           /*!< Standstill before the hold current is used.    */
 
 // PIN definition
 #define step1        14
 #define dir1         13
 #define enableMotor  2
-#define z_endstop    4
+#define z_endstop    4              // Endstop switch to GND, TMC2209 build - driver DIAG output (sensorless homing)
+#define enc_a        5              // Quadrature encoder A (D1) - OPTIONAL, enabled by the ENC command
+#define enc_b        12             // Quadrature encoder B (D6)
+#ifdef DRIVER_TMC2209
+#define ENDSTOP_LEVEL HIGH
+#else
+#define ENDSTOP_LEVEL LOW
+#endif
 
 
 #define SERIAL_PORT Serial    // TMC2208/TMC2224 HardwareSerial port
 #define R_SENSE     0.11      // SilentStepStick series use 0.11     Watterott TMC5160 uses 0.075
+#define TMC_ADDR    0         // TMC2209 slave address (MS1/MS2 pins), ignored by TMC2208
 
 
 #ifdef DEBUG_ENABLED
@@ -43,24 +66,72 @@ class WiFiManager {
 #include "secrets.h"
 
 /* Global variables */
-TMC2208Stepper driver = TMC2208Stepper(&SERIAL_PORT, R_SENSE); // Hardware Serial0
+TMC2208Uart       driver(&SERIAL_PORT, R_SENSE, TMC_ADDR);  // Hardware Serial0
 Motion1D          *m1d;
 CommandDB         CmdDB;
 NetworkCommand    *NCmd;
 HTTPCommand       *HCmd;
+FileCommand       *FCmd;
 volatile int ota_in_progress = 0;
 static int current_microsteps = 256;
+static int g_stealth_rpm = STEALTH_RPM;   /*!< StealthChop threshold (0 - always, < 0 - SpreadCycle only). */
+static uint32_t g_idle_off_ms = 0;        /*!< Disable the driver after idle time (0 - never). */
+static uint32_t g_idle_since  = 0;        /*!< Idle (or motors enabled) since (millis).        */
+static int g_pos_x = 0;              /*!< Global position estimation (in 1/256 microsteps). */
+static int g_pos_resync = 0;         /*!< Resync g_pos_x with x_pos when motion ends.    */
+static Command *g_home_parent = NULL; /*!< Client waiting for the homing cycle result.  */
+static int g_loop_n = 0;             /*!< Number of open (queued) loops.                 */
+static int g_loop_pos[MOTION_LOOP_DEPTH];   /*!< g_pos_x at loop begin.                  */
+static int g_loop_count[MOTION_LOOP_DEPTH]; /*!< Loop iterations (0 - forever).          */
+static int g_loop_min[MOTION_LOOP_DEPTH];   /*!< Lowest g_pos_x in the loop body.        */
+static int g_loop_max[MOTION_LOOP_DEPTH];   /*!< Highest g_pos_x in the loop body.       */
+/* Step rate self-test levels in [steps/s] (stops at the first level with missed edges) */
+static const int g_rate_levels[] = {5000, 7500, 10000, 15000, 20000, 25000, 30000, 40000, 50000, 60000, 80000, 100000};
+#define STEPRATE_LEVELS          (sizeof(g_rate_levels)/sizeof(g_rate_levels[0]))
+#define STEPRATE_FILE            "/steprate"
+/* Lost-step detection - MSCNT is read when the position is stable for MSCNT_SETTLE_MS */
+#define MSCNT_SETTLE_MS          (20)
+static int      g_mscnt_pos     = 0;         /*!< Last seen position.                    */
+static uint32_t g_mscnt_since   = 0;         /*!< Position is stable since (millis).     */
+static boolean  g_mscnt_need    = 1;         /*!< Position was not checked yet.          */
+static boolean  g_mscnt_busy    = 0;         /*!< MSCNT read is in progress.             */
+static boolean  g_mscnt_ref     = 0;         /*!< MSCNT reference (phase) is set.        */
 
 static void makeCmdInterface();
+static void planPos(int pos);
+static void loadStepRate();
+static void mscntLoop();
+static void powerLoop();
+#ifdef DRIVER_TMC2209
+static void stallLoop();
+#endif
+#ifdef enc_a
+static void encoderLoop();
+#endif
+#ifdef z_endstop
+static void homeDone(int result);
+#endif
+
+/*!
+ * \brief Speed in [1/256 microsteps/s] from [rev/min] (sign is kept).
+ * Does not change with S or automatic resolution (driver TSTEP is measured in 1/256 microsteps too).
+ */
+static int rpmSpeed(int rpm)
+{
+	return (rpm * 200 * MICROSTEP_FINE) / 60;
+}
+//====================================================================================
 
 /*!
  * \brief Setup.
  * 1. Configure gpio.
  * 2. Connect to WiFi.
  * 3. Setup OTA.
- * 4. Register available commands.
- * 5. Configure TMC2208.
- * 6. Create Motion1D controller.
+ * 4. Mount filesystem.
+ * 5. Register available commands.
+ * 6. Configure TMC2208.
+ * 7. Create Motion1D controller.
+ * 8. Start autorun program (program 0).
  */
 void setup()
 {
@@ -71,7 +142,11 @@ void setup()
 	pinMode(dir1, OUTPUT);
 	digitalWrite(enableMotor, HIGH);
 #ifdef z_endstop
-	pinMode(z_endstop, INPUT_PULLUP);
+	pinMode(z_endstop, (ENDSTOP_LEVEL) ? INPUT : INPUT_PULLUP);
+#endif
+#ifdef enc_a
+	pinMode(enc_a, INPUT_PULLUP);
+	pinMode(enc_b, INPUT_PULLUP);
 #endif	
 	/* Connect to WiFi */
 	detect_network();
@@ -87,21 +162,59 @@ void setup()
 	});
 	ArduinoOTA.begin();
 	
+	if (!LittleFS.begin()) {
+		pdebug("LittleFS mount failed\n");
+	}
+	loadStepRate();
 	makeCmdInterface();
 	
-	/* Setup driver */
+	/* Setup driver (shadow registers, written by driver.loop() - one datagram per register) */
 	digitalWrite(enableMotor, LOW);    // Enable driver in hardware
 	driver.begin();
-	driver.pdn_disable(true);          // Use PDN/UART pin for communication
-	driver.I_scale_analog(false);      // Use internal voltage reference
-	driver.rms_current(300);           // Set motor RMS current
-	driver.mstep_reg_select(1);        // necessary for TMC2208 to set microstep register with UART
-	driver.microsteps(16);
+	// Use PDN/UART pin for communication, internal voltage reference, microstep register set by UART
+	driver.set(TMC_GCONF, GCONF_PDN_DISABLE | GCONF_I_SCALE_ANALOG | GCONF_MSTEP_REG_SELECT, GCONF_PDN_DISABLE | GCONF_MSTEP_REG_SELECT);
+	driver.rmsCurrent(300);            // Set motor RMS current
+	driver.holdCurrent(TMC_HOLD_PERCENT, HOLD_SETTLE_MS);  // Reduced current at standstill
+	// Enables driver in software (toff = 5), interpolate to 256 microsteps (resolution is switched by speed)
+	driver.set(TMC_CHOPCONF, CHOPCONF_TOFF_MASK | CHOPCONF_INTPOL | CHOPCONF_MRES_MASK, 5 | CHOPCONF_INTPOL | (TMC2208Uart::mres(16) << CHOPCONF_MRES_SHIFT));
+	driver.set(TMC_PWMCONF, PWMCONF_AUTOSCALE, PWMCONF_AUTOSCALE);  // Needed for stealthChop
+	driver.stealthChop(rpmSpeed(g_stealth_rpm));                 // Silent slow moves, SpreadCycle on rapids
+#ifdef DRIVER_TMC2209
+	driver.stallGuard(STALL_THRESHOLD, rpmSpeed(STALL_MIN_RPM)); // DIAG output for sensorless homing
+#endif
 	current_microsteps = 16;
-	driver.toff(5);                    // Enables driver in software
-	//  driver.en_pwm_mode(true);      // Enable stealthChop
-	driver.pwm_autoscale(true);        // Needed for stealthChop
 	m1d = new Motion1D(step1, dir1, enableMotor);
+	m1d->onResolution([](int ms) {
+		driver.microsteps(ms, [](bool ok, uint32_t v) {m1d->resolutionDone();});
+	});
+	// Hybrid cruise - VACTUAL (24 bit two's complement) confirmed by IFCNT (the write has no reply),
+	// MSCNT sampled at the end of the read request
+	m1d->onHybrid([](int vactual) -> boolean {
+		static int ifcnt;
+
+		if (!driver.room(3)) return false;
+		driver.read(TMC_IFCNT, [](bool ok, uint32_t v) {ifcnt = (ok) ? (int)(v & 0xff) : -1;});
+		driver.write(TMC_VACTUAL, vactual & 0xffffff);
+		driver.read(TMC_IFCNT, [](bool ok, uint32_t v) {m1d->velocityDone((ok) && (ifcnt >= 0) && (((v - ifcnt) & 0xff) == 1));});
+		return true;
+	}, []() -> boolean {
+		return driver.read(TMC_MSCNT, [](bool ok, uint32_t v) {m1d->hybridMscnt(ok, v, driver.m_t0 + driver.m_txTime);});
+	});
+	m1d->setMicrosteps(current_microsteps);
+#ifdef z_endstop
+	m1d->endstopBegin(z_endstop, ENDSTOP_LEVEL);
+	m1d->onHome(homeDone);
+#ifdef DRIVER_TMC2209
+	/* StallGuard is not reliable at the slow approach speed - the first stall is the zero point */
+	m1d->setHomeSingle(1);
+#endif
+#endif
+#ifdef enc_a
+	m1d->encoderBegin(enc_a, enc_b);
+#endif
+	if (FCmd->play(0, NULL) == FILE_PLAY_OK) {
+		pdebug("Autorun program started\n");
+	}
 	pdebug("Setup done :-)\n");
 }
 //====================================================================================
@@ -109,8 +222,10 @@ void setup()
 /*!
  * \brief MAIN loop.
  * 1. Handle OTA.
- * 2. Handle CMD queue.
- * 3. Handle motion loop.
+ * 2. Handle driver UART transactions, lost-step detection and idle power down.
+ * 3. Stream stored program.
+ * 4. Handle CMD queue.
+ * 5. Handle motion loop.
  */
 void loop()
 {
@@ -118,10 +233,28 @@ void loop()
 	ArduinoOTA.handle();
 	if (ota_in_progress) return;
 
+	/* Driver registers */
+	driver.loop();
+	mscntLoop();
+	powerLoop();
+#ifdef DRIVER_TMC2209
+	stallLoop();
+#endif
+#ifdef enc_a
+	encoderLoop();
+#endif
+
+	/* Stream stored program */
+	FCmd->loop();
+
 	/* Execute command from queue */
 	if ( m1d->loop() ) {
 		CmdDB.loop();
 	} else {
+		if (g_pos_resync) {
+			g_pos_x      = m1d->position();
+			g_pos_resync = 0;
+		}
 		CmdDB.loopMotion();
 		CmdDB.loop();
 	}
@@ -129,12 +262,107 @@ void loop()
 //====================================================================================
 
 /*!
- * \brief Global position estimation.
+ * \brief Send event (error) to all command channels.
  */
-static int g_pos_x = 0;
+static void sendEvent(String s)
+{
+	NCmd->print(s);
+	HCmd->print(s);
+}
+//====================================================================================
 
+/*!
+ * \brief Lost-step detection - compare driver MSCNT with the position at every standstill.
+ * The first read sets the reference (driver phase at position 0), later mismatches are reported.
+ * Hybrid cruise tracking loss is reported here too, the motion is stopped and the queue flushed.
+ */
+static void mscntLoop()
+{
+	int pos = m1d->position();
 
-#define MAX_DIST_MOTTOR (45)
+	if (m1d->hybridFault()) {
+		/* Queued moves were planned from an unverified position */
+		m1d->stop();
+		g_pos_resync = 1;
+		sendEvent("!8 Err: Hybrid cruise lost track at " + String(pos) + " - position not verified\r\n");
+	}
+	/* Hybrid cruise reads MSCNT itself */
+	if (m1d->isHybrid()) {
+		g_mscnt_need = 1;
+		return;
+	}
+	if (pos != g_mscnt_pos) {
+		g_mscnt_pos   = pos;
+		g_mscnt_since = millis();
+		g_mscnt_need  = 1;
+		return;
+	}
+	if ((!g_mscnt_need) || (g_mscnt_busy) || (pos != m1d->target()) || ((millis() - g_mscnt_since) < MSCNT_SETTLE_MS)) return;
+	g_mscnt_busy = driver.read(TMC_MSCNT, [pos](bool ok, uint32_t v) {
+		int d;
+
+		g_mscnt_busy = 0;
+		/* Moved meanwhile - check at the next standstill */
+		if ((!ok) || (m1d->position() != pos) || (m1d->target() != pos)) return;
+		g_mscnt_need = 0;
+		if (!g_mscnt_ref) {
+			m1d->mscntSync(v);
+			g_mscnt_ref = 1;
+			return;
+		}
+		if ((d = m1d->mscntCheck(v)) != 0) {
+			sendEvent("!8 Err: Lost steps " + String(d) + "/256 microsteps at " + String(pos) + "\r\n");
+		}
+	});
+}
+//====================================================================================
+
+/*!
+ * \brief Idle power down - disable the driver when the slider stands still (queue empty) for g_idle_off_ms.
+ * The next move enables it again (EN pin), standstill current reduction is done by the driver itself.
+ */
+static void powerLoop()
+{
+	if ((m1d->isInMotion()) || (!m1d->m_motorsEnabled)) {
+		g_idle_since = millis();
+		return;
+	}
+	if ((g_idle_off_ms) && ((millis() - g_idle_since) >= g_idle_off_ms)) {
+		m1d->motorsOff();
+	}
+}
+//====================================================================================
+
+#ifdef DRIVER_TMC2209
+/*!
+ * \brief Stall detection - motion was stopped by the driver DIAG output, the position is not trusted anymore.
+ */
+static void stallLoop()
+{
+	int pos;
+
+	if (!m1d->stallHit(&pos)) return;
+	m1d->stop();
+	g_pos_resync = 1;
+	sendEvent("!8 Err: Stall at " + String(pos) + " - home again\r\n");
+}
+//====================================================================================
+#endif
+
+#ifdef enc_a
+/*!
+ * \brief Encoder following error - the motion was stopped, the position was taken from the encoder.
+ */
+static void encoderLoop()
+{
+	int e;
+
+	if (!m1d->encoderFault(&e)) return;
+	g_pos_resync = 1;
+	sendEvent("!8 Err: Following error " + String(e) + "/256 microsteps at " + String(m1d->position()) + "\r\n");
+}
+//====================================================================================
+#endif
 
 /*!
  * \brief Move to revolution command (absolute move).
@@ -153,31 +381,29 @@ static void stepperMoveAbsoluteRev(CommandQueueItem *c)
 	}
 	
 	/* Limit move distance */
-	if (newS > MAX_DIST_MOTTOR) newS = MAX_DIST_MOTTOR;
-	if (newS < 0) newS = 0;
-	if (newE > MAX_DIST_MOTTOR) newE = MAX_DIST_MOTTOR;
-	if (newE < 0) newE = 0;
+	newS = planner_clamp(newS, MAX_DIST_MOTTOR);
+	newE = planner_clamp(newE, MAX_DIST_MOTTOR);
 	
-	/* Convert to microsteps */
-	newS*=(200 * current_microsteps);
-	newE*=(200 * current_microsteps);
+	/* Convert to position units */
+	newS*=(200 * MICROSTEP_FINE);
+	newE*=(200 * MICROSTEP_FINE);
 
 	dX = newS - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 
 	/* Calculate duration in [ms] */
 	if (aX) {
-		duration = (aX * 1000)/speed;
+		duration = planner_speed_duration(aX, m1d->fromMicrosteps(speed));
 		m1d->goTo(duration, dX);
 	}
-	g_pos_x = newS;
+	planPos(newS);
 
 	dX = newE - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 	if (aX) {
 		m1d->goTo(d, dX);
 	}
-	g_pos_x = newE;
+	planPos(newE);
 	c->sendAck();
 }
 //====================================================================================
@@ -188,23 +414,22 @@ static void stepperMoveAbsoluteRev(CommandQueueItem *c)
 static void stepperMoveRelativeRev(CommandQueueItem *c)
 {
 	int d        = c->m_arg0;
-	int newS     = g_pos_x + (c->m_arg1 * 200 * current_microsteps);
-	int aX, dX, mm = MAX_DIST_MOTTOR * 200 * current_microsteps;
+	int newS     = g_pos_x + (c->m_arg1 * 200 * MICROSTEP_FINE);
+	int aX, dX, mm = MAX_POS;
 
 	if ((c->m_arg_mask & 3) != 3) {
 		c->sendError();
 		return;
 	}
 	/* Limit move distance */
-	if (newS > mm) newS = mm;
-	if (newS < 0) newS = 0;
+	newS = planner_clamp(newS, mm);
 	
 	dX = newS - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 	if (aX) {
 		m1d->goTo(d, dX);
 	}
-	g_pos_x = newS;
+	planPos(newS);
 	c->sendAck();
 }
 //====================================================================================
@@ -215,11 +440,11 @@ static void stepperMoveRelativeRev(CommandQueueItem *c)
 static void stepperMoveAbsolute(CommandQueueItem *c)
 {
 	int d        = c->m_arg0;
-	int newS     = c->m_arg1;
-	int newE     = c->m_arg2;
+	int newS     = m1d->fromMicrosteps(c->m_arg1);
+	int newE     = m1d->fromMicrosteps(c->m_arg2);
 	int duration, aX, dX;
-	int speed    = 3000;
-	int mm = MAX_DIST_MOTTOR * 200 * current_microsteps;
+	int speed    = m1d->fromMicrosteps(3000);
+	int mm = MAX_POS;
 
 	if ((c->m_arg_mask & 7) != 7) {
 		c->sendError();
@@ -227,27 +452,25 @@ static void stepperMoveAbsolute(CommandQueueItem *c)
 	}
 	
 	/* Limit move distance */
-	if (newS > mm) newS = mm;
-	if (newS < 0) newS = 0;
-	if (newE > mm) newE = mm;
-	if (newE < 0) newE = 0;
+	newS = planner_clamp(newS, mm);
+	newE = planner_clamp(newE, mm);
 	
 	dX = newS - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 
 	/* Calculate duration in [ms] */
 	if (aX) {
-		duration = (aX * 1000)/speed;
+		duration = planner_speed_duration(aX, speed);
 		m1d->goTo(duration, dX);
 	}
-	g_pos_x = newS;
+	planPos(newS);
 
 	dX = newE - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 	if (aX) {
 		m1d->goTo(d, dX);
 	}
-	g_pos_x = newE;
+	planPos(newE);
 	c->sendAck();
 }
 //====================================================================================
@@ -258,23 +481,22 @@ static void stepperMoveAbsolute(CommandQueueItem *c)
 static void stepperMoveRelative(CommandQueueItem *c)
 {
 	int d        = c->m_arg0;
-	int newS     = g_pos_x + c->m_arg1;
-	int aX, dX, mm = MAX_DIST_MOTTOR * 200 * current_microsteps;
+	int newS     = g_pos_x + m1d->fromMicrosteps(c->m_arg1);
+	int aX, dX, mm = MAX_POS;
 
 	if ((c->m_arg_mask & 3) != 3) {
 		c->sendError();
 		return;
 	}
 	/* Limit move distance */
-	if (newS > mm) newS = mm;
-	if (newS < 0) newS = 0;
+	newS = planner_clamp(newS, mm);
 	
 	dX = newS - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 	if (aX) {
 		m1d->goTo(d, dX);
 	}
-	g_pos_x = newS;
+	planPos(newS);
 	c->sendAck();
 }
 //====================================================================================
@@ -285,7 +507,7 @@ static void stepperMoveRelative(CommandQueueItem *c)
 static void stepperMoveUncondicional(CommandQueueItem *c)
 {
 	int d        = c->m_arg0;
-	int newS     = g_pos_x + c->m_arg1;
+	int newS     = g_pos_x + m1d->fromMicrosteps(c->m_arg1);
 	int aX, dX;
 
 	if ((c->m_arg_mask & 3) != 3) {
@@ -302,13 +524,302 @@ static void stepperMoveUncondicional(CommandQueueItem *c)
 }
 //====================================================================================
 
+/*!
+ * \brief Custom curve control ordinates (in [1/1000]), presets are taken from the planner.
+ */
+static int g_curve_custom[2] = {0, 1000};
+
+/*!
+ * \brief Relative curve move command (in microsteps) - BZ,duration [ms],delta microsteps,curve.
+ */
+static void stepperMoveCurve(CommandQueueItem *c)
+{
+	int d        = c->m_arg0;
+	int newS     = g_pos_x + m1d->fromMicrosteps(c->m_arg1);
+	int curve    = CURVE_EASE_IN_OUT;
+	int dX, mm = MAX_POS;
+
+	if ((c->m_arg_mask & 3) != 3) {
+		c->sendError();
+		return;
+	}
+	if (c->m_arg_mask & 4) curve = c->m_arg2;
+	if ((curve < CURVE_LINEAR) || (curve > CURVE_CUSTOM)) {
+		c->sendError();
+		return;
+	}
+	/* Limit move distance */
+	newS = planner_clamp(newS, mm);
+
+	dX = newS - g_pos_x;
+	if (dX) {
+		if (curve == CURVE_CUSTOM) {
+			m1d->goCurve(d, dX, g_curve_custom[0], g_curve_custom[1]);
+		} else {
+			m1d->goCurve(d, dX, planner_curve_p[curve][0], planner_curve_p[curve][1]);
+		}
+	}
+	planPos(newS);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Set custom curve control ordinates - BZC,p1,p2 (in [1/1000], 0..1000).
+ */
+static void cmdCurve(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 3) != 3) || (c->m_arg0 < 0) || (c->m_arg0 > 1000) || (c->m_arg1 < 0) || (c->m_arg1 > 1000)) {
+		c->sendError();
+		return;
+	}
+	g_curve_custom[0] = c->m_arg0;
+	g_curve_custom[1] = c->m_arg1;
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Clear speed map command (SMC).
+ */
+static void cmdSpeedMapClear(CommandQueueItem *c)
+{
+	if (m1d->isInMotion()) {
+		c->sendErrorText("Busy");
+		return;
+	}
+	m1d->mapClear();
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Add speed map knot command (SMK,position [microsteps],speed [rev/min]).
+ */
+static void cmdSpeedMapKnot(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 3) != 3) || (c->m_arg1 <= 0)) {
+		c->sendError();
+		return;
+	}
+	if (m1d->isInMotion()) {
+		c->sendErrorText("Busy");
+		return;
+	}
+	/* Speed in [1/256 microsteps/s] - independent of S and of the resolution the move runs with */
+	if (!m1d->mapAdd(m1d->fromMicrosteps(c->m_arg0), rpmSpeed(c->m_arg1))) {
+		c->sendErrorText("Speed map full");
+		return;
+	}
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Absolute move with speed taken from the speed map (SMM,target microstep).
+ */
+static void stepperMoveSpeedMap(CommandQueueItem *c)
+{
+	int newS     = m1d->fromMicrosteps(c->m_arg0);
+	int mm = MAX_POS;
+
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	if (m1d->mapEmpty()) {
+		c->sendErrorText("Speed map empty");
+		return;
+	}
+	/* Limit move distance */
+	newS = planner_clamp(newS, mm);
+
+	if (newS != g_pos_x) {
+		m1d->goMap(newS - g_pos_x);
+	}
+	planPos(newS);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Dwell command (DW,duration [ms]) - hardware timed pause between moves.
+ */
+static void stepperDwell(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 1) != 1) || (c->m_arg0 < 0)) {
+		c->sendError();
+		return;
+	}
+	m1d->dwell(c->m_arg0);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Planned position after a queued move - excursion of the open loop bodies is recorded.
+ */
+static void planPos(int pos)
+{
+	g_pos_x = pos;
+	for (int i = 0; i < g_loop_n; ++i) {
+		if (pos < g_loop_min[i]) g_loop_min[i] = pos;
+		if (pos > g_loop_max[i]) g_loop_max[i] = pos;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Plan loop begin (count 0 - repeat forever), return error text or NULL.
+ */
+static const char *planLoopBegin(int count)
+{
+	if ((count < 0) || (g_loop_n >= MOTION_LOOP_DEPTH) || (!m1d->loopBegin(count))) return "Invalid loop";
+	g_loop_pos[g_loop_n]   = g_pos_x;
+	g_loop_count[g_loop_n] = count;
+	g_loop_min[g_loop_n]   = g_pos_x;
+	g_loop_max[g_loop_n]   = g_pos_x;
+	g_loop_n++;
+	return NULL;
+}
+//====================================================================================
+
+/*!
+ * \brief Plan loop end, return error text or NULL.
+ * Every iteration k is the body shifted by k * net, so the body excursion must stay in limits
+ * in the first and the last iteration, endless loop must return to the start position.
+ */
+static const char *planLoopEnd()
+{
+	int     net, n, last;
+	int64_t lo, hi;
+
+	if (g_loop_n == 0) return "No open loop";
+	n    = --g_loop_n;
+	net  = g_pos_x - g_loop_pos[n];
+	last = (g_loop_count[n]) ? g_loop_count[n] - 1 : 0;
+	if ((g_loop_count[n] == 0) && (net)) {
+		m1d->loopCancel();
+		return "Endless loop must return to start position";
+	}
+	lo = g_loop_min[n] + ((net < 0) ? (int64_t)net * last : 0);
+	hi = g_loop_max[n] + ((net > 0) ? (int64_t)net * last : 0);
+	if ((lo < 0) || (hi > MAX_POS)) {
+		m1d->loopCancel();
+		return "Loop out of range";
+	}
+	if (!m1d->loopEnd()) return "Loop does not fit into motion queue";
+	/* Outer loops see the excursion of all iterations */
+	planPos((int)lo);
+	planPos((int)hi);
+	g_pos_x = g_loop_pos[n] + net + net * last;
+	return NULL;
+}
+//====================================================================================
+
+/*!
+ * \brief Loop begin command (LB,count), count 0 - repeat forever.
+ */
+static void stepperLoopBegin(CommandQueueItem *c)
+{
+	const char *err = planLoopBegin((c->m_arg_mask & 1) ? c->m_arg0 : 0);
+
+	if (err) {
+		c->sendError();
+		return;
+	}
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Loop end command (LE).
+ */
+static void stepperLoopEnd(CommandQueueItem *c)
+{
+	const char *err = planLoopEnd();
+
+	if (err) {
+		c->sendErrorText(err);
+		return;
+	}
+	c->sendAck();
+}
+//====================================================================================
+
 /*!
  * \brief STOP movement.
  */
 static void stepperMoveStop(CommandQueueItem *c)
 {
+	FCmd->stopPlay();
 	m1d->stop();
-	g_pos_x = x_pos;
+	g_pos_x  = m1d->position();
+	g_loop_n = 0;
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Soft STOP - flush queues and ramp down to standstill.
+ */
+static void stepperMoveSoftStop(CommandQueueItem *c)
+{
+	FCmd->stopPlay();
+	CmdDB.m_motionQueue.clear();
+	m1d->softStop();
+	g_pos_x  = m1d->target();
+	g_loop_n = 0;
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Pause motion queue (decelerate to halt, keep the rest of the program).
+ */
+static void stepperPause(CommandQueueItem *c)
+{
+	if (m1d->isJogging()) {
+		c->sendErrorText("Busy");
+		return;
+	}
+	m1d->pause();
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Resume paused motion queue.
+ */
+static void stepperResume(CommandQueueItem *c)
+{
+	m1d->resume();
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Jog (velocity mode) command (JOG,speed [rev/min],timeout [ms]).
+ * Repeat the command before timeout expires to keep moving, speed 0 - ramp down and stop.
+ */
+static void stepperJog(CommandQueueItem *c)
+{
+	int speed, limit, timeout = JOG_TIMEOUT;
+
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	if (c->m_arg_mask & 2) timeout = c->m_arg1;
+	if ((!m1d->isJogging()) && ((m1d->isInMotion()) || (CmdDB.m_motionQueue.size()))) {
+		c->sendErrorText("Busy");
+		return;
+	}
+	/* Convert [rev/min] to [microsteps/s] */
+	speed = (c->m_arg0 * 200 * current_microsteps) / 60;
+	limit = (speed < 0) ? 0 : MAX_POS;
+	m1d->jog(speed, limit, timeout);
+	g_pos_resync = 1;
 	c->sendAck();
 }
 //====================================================================================
@@ -318,64 +829,140 @@ static void stepperMoveStop(CommandQueueItem *c)
  */
 void cmdG90(CommandQueueItem *c)
 {
-	m1d->stop();
+	m1d->setZero();
 	g_pos_x  = 0;
-	x_pos    = 0;
-	x_target = 0;
 	c->sendAck();
 }
 //====================================================================================
 
+#ifdef z_endstop
+/*!
+ * \brief Homing cycle finished - reply to the client that started it.
+ */
+static void homeDone(int result)
+{
+	Command *p = g_home_parent;
+
+	g_home_parent = NULL;
+	/* Queue was flushed - planned position follows the slider again */
+	if (result != HOME_OK) g_pos_resync = 1;
+	if (!p) return;
+	switch (result) {
+		case HOME_OK: p->print("OK\r\n"); break;
+		case HOME_NOT_FOUND: p->print("!8 Err: Can not find HOME edge!!!\r\n"); break;
+		case HOME_NOT_RELEASED: p->print("!8 Err: HOME switch still active after back-off!!!\r\n"); break;
+		default: p->print("!8 Err: Homing cancelled\r\n"); break;
+	}
+}
+//====================================================================================
+#endif
+
 /*!
  * \brief CmdHome (detect home).
+ * Queues the homing cycle (fast approach, back-off, slow approach - the position latched by the
+ * endstop interrupt becomes zero), the reply is sent when the cycle is finished.
+ * Sensorless homing (TMC2209) stops at the first stall and backs off from the hard stop.
  */
 void cmdHome(CommandQueueItem *c)
 {
 #ifdef z_endstop
-	/* Execute movement */
-	int newS     = g_pos_x - ((MAX_DIST_MOTTOR + 1) * 200 * current_microsteps);
-	int duration, aX, dX;
-	int speed    = 6000;
-
-	dX = newS - g_pos_x;
-	if (dX < 0) aX = -dX; else aX = dX;
-	/* Calculate duration in [ms] */
-	if (aX) {
-		duration = (aX * 1000)/speed;
-		m1d->goTo(duration, dX);
-	}
-	g_pos_x = newS;
-	/* Wait for motion to end */
-	while ( m1d->isInMotion() ) {
-		m1d->loop();
-		CmdDB.loop();
-		if ((digitalRead(z_endstop)) == 0) {
-			cmdG90(c);
-			return;
-		}
-		yield();
+	if ((g_home_parent) || (m1d->isHoming())) {
+		c->sendErrorText("Homing in progress");
+		return;
 	}
-	c->sendErrorText("Can not find HOME edge!!!");
+	g_home_parent = c->m_parent;
+	m1d->goHome(-((MAX_DIST_MOTTOR + 1) * 200 * MICROSTEP_FINE), rpmSpeed(HOME_RPM));
+	/* Following moves are planned from the new zero */
+	g_pos_x = 0;
+#ifdef DRIVER_TMC2209
+	/* Sensorless - zero is at the hard stop, move away from it */
+	m1d->goTo(planner_speed_duration(HOME_BACKOFF, rpmSpeed(HOME_RPM)), HOME_BACKOFF);
+	g_pos_x = HOME_BACKOFF;
+#endif
 #else
 	/* GoTo 0 */
 	int newS     = 0;
 	int duration, aX, dX;
-	int speed    = 3000;
+	int speed    = m1d->fromMicrosteps(3000);
 
 	dX = newS - g_pos_x;
 	if (dX < 0) aX = -dX; else aX = dX;
 	/* Calculate duration in [ms] */
 	if (aX) {
-		duration = (aX * 1000)/speed;
+		duration = planner_speed_duration(aX, speed);
 		m1d->goTo(duration, dX);
 	}
-	g_pos_x = newS;
+	planPos(newS);
 	c->sendAck();
 #endif
 }
 //====================================================================================
 
 
+/*!
+ * \brief Set feed-rate override in [%] command (FO,percent).
+ */
+static void cmdOverride(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 1) != 1) || (c->m_arg0 < 10) || (c->m_arg0 > 500)) {
+		c->sendError();
+		return;
+	}
+	m1d->setOverride(c->m_arg0);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief StealthChop threshold command (SC,speed [rev/min]), 0 - StealthChop at all speeds, -1 - SpreadCycle only.
+ * The driver switches chopper mode by itself when the planned (ramped, overridden) speed crosses the threshold.
+ */
+static void cmdStealthChop(CommandQueueItem *c)
+{
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	g_stealth_rpm = c->m_arg0;
+	driver.stealthChop(rpmSpeed(g_stealth_rpm));
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Hold current command (HC,hold [%],settle [ms][,off [s]]) - current at standstill, driver
+ * is disabled after off seconds of idle time (0 - never).
+ */
+static void cmdHoldCurrent(CommandQueueItem *c)
+{
+	if ((c->m_arg_mask & 3) != 3) {
+		c->sendError();
+		return;
+	}
+	driver.holdCurrent(c->m_arg0, c->m_arg1);
+	if (c->m_arg_mask & 4) g_idle_off_ms = (c->m_arg2 > 0) ? (uint32_t)c->m_arg2 * 1000 : 0;
+	c->sendAck();
+}
+//====================================================================================
+
+#ifdef DRIVER_TMC2209
+/*!
+ * \brief StallGuard command (SG,threshold[,stop]) - SGTHRS (0 - disabled), stop - stop the motion at a stall.
+ * DIAG is active above STALL_MIN_RPM in StealthChop only (see SC).
+ */
+static void cmdStallGuard(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 1) != 1) || (c->m_arg0 < 0) || (c->m_arg0 > 255)) {
+		c->sendError();
+		return;
+	}
+	driver.stallGuard(c->m_arg0, (c->m_arg0) ? rpmSpeed(STALL_MIN_RPM) : 0);
+	m1d->stallDetect((c->m_arg0) && (c->m_arg_mask & 2) && (c->m_arg1));
+	c->sendAck();
+}
+//====================================================================================
+#endif
+
 /*!
  * \brief Set mottor current in [mA] command.
  */
@@ -385,23 +972,51 @@ static void cmdCurrent(CommandQueueItem *c)
 		c->sendError();
 		return;
 	}
-	driver.rms_current(c->m_arg0);
+	driver.rmsCurrent(c->m_arg0);
 	c->sendAck();
 }
 //====================================================================================
 
 /*!
- * \brief Set microsteps per step command.
+ * \brief Set microsteps per step command - unit of the following motion commands.
+ * Positions are kept in 1/256 microsteps, so the resolution may be changed at any time.
  */
 static void cmdSteps(CommandQueueItem *c)
+{
+	if (((c->m_arg_mask & 1) != 1) || (c->m_arg0 < 1) || (c->m_arg0 > MICROSTEP_FINE)) {
+		c->sendError();
+		return;
+	}
+	m1d->setMicrosteps(c->m_arg0);
+	current_microsteps = m1d->microsteps();
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Automatic microstep resolution command (SA,enable).
+ */
+static void cmdAutoSteps(CommandQueueItem *c)
 {
 	if ((c->m_arg_mask & 1) != 1) {
 		c->sendError();
 		return;
 	}
-	driver.mstep_reg_select(1);        // necessary for TMC2208 to set microstep register with UART
-	driver.microsteps(c->m_arg0);
-	current_microsteps = c->m_arg0;
+	m1d->setAutoMicrosteps(c->m_arg0 != 0);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Hybrid cruise command (VA,enable) - long cruise phases run from the driver VACTUAL.
+ */
+static void cmdHybrid(CommandQueueItem *c)
+{
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	m1d->setHybrid(c->m_arg0 != 0);
 	c->sendAck();
 }
 //====================================================================================
@@ -433,6 +1048,251 @@ static void enableMotors(CommandQueueItem *c)
 }
 //====================================================================================
 
+/*!
+ * \brief Binary program header - apply program settings.
+ * The start position is checked first, a rejected program leaves the settings untouched.
+ */
+static int programHeader(const motion_program_hdr_t *h)
+{
+	int mm = MAX_DIST_MOTTOR * 200 * h->microsteps;
+
+	if ((h->microsteps == 0) || (h->start < 0) || (h->start > mm)) return -1;
+	if (h->flags & SEGMENT_FILE_ZERO) {
+		/* Zero point can be changed only at standstill, the program starts at it */
+		if ((h->start != 0) || (m1d->isInMotion()) || (CmdDB.m_motionQueue.size())) return -1;
+	} else if (g_pos_x != (h->start << Motion1D::unitShift(h->microsteps))) {
+		/* Program was compiled for the given start position */
+		return -1;
+	}
+	if (h->microsteps != current_microsteps) {
+		m1d->setMicrosteps(h->microsteps);
+		current_microsteps = m1d->microsteps();
+	}
+	if (h->current) driver.rmsCurrent(h->current);
+	if (h->flags & SEGMENT_FILE_ZERO) {
+		m1d->setZero();
+		g_pos_x = 0;
+	}
+	return 1;
+}
+//====================================================================================
+
+/*!
+ * \brief Binary program segment - push directly to the motion queue.
+ */
+static int programSegment(const motion_segment_t *s)
+{
+	int dX, newS, mm = MAX_POS;
+
+	/* Keep order with queued text commands */
+	if ((CmdDB.m_motionQueue.size()) || (m1d->motionQ_is_full())) return 0;
+	switch (s->type) {
+		case MOTION_CMD_MOVE:
+		case MOTION_CMD_CURVE: {
+			dX   = m1d->fromMicrosteps(s->steps);
+			newS = g_pos_x + dX;
+			if ((!(s->flags & SEGMENT_NO_LIMIT)) && ((newS < 0) || (newS > mm))) return -1;
+			if (s->type == MOTION_CMD_MOVE) {
+				m1d->goToPeriod(s->value, dX);
+			} else {
+				m1d->goCurve(s->value, dX, s->arg >> 16, s->arg & 0xffff);
+			}
+			if (s->flags & SEGMENT_NO_LIMIT) g_pos_x = newS; else planPos(newS);
+		} break;
+		case MOTION_CMD_DWELL: m1d->dwell(s->value); break;
+		case MOTION_CMD_LOOP: if (planLoopBegin(s->value)) return -1; break;
+		case MOTION_CMD_ENDL: if (planLoopEnd()) return -1; break;
+		default: return -1;
+	}
+	return 1;
+}
+//====================================================================================
+
+/*!
+ * \brief Load measured minimum STEP period (step rate self-test result) from flash.
+ */
+static void loadStepRate()
+{
+	uint32_t p = 0;
+	File     f = LittleFS.open(STEPRATE_FILE, "r");
+
+	if (!f) return;
+	if ((f.read((uint8_t *)&p, sizeof(p)) == sizeof(p)) && (p >= PLANNER_CLOCK / g_rate_levels[STEPRATE_LEVELS - 1])) {
+		planner_min_period = p;
+		pdebug("Minimum STEP period %u\n", p);
+	}
+	f.close();
+}
+//====================================================================================
+
+/*!
+ * \brief Step rate self-test command (SRT,driver) - motor driver 0 - disabled (default), 1 - enabled.
+ * Runs the step generator at increasing rates (forward and back) until timer edges are missed,
+ * the highest clean rate minus 20% margin becomes the planner limit (stored in flash).
+ * With the driver enabled the runs go towards the farther soft limit and stay inside it, the motor may
+ * lose steps at the unramped start, so the position is not trusted afterwards (home again).
+ */
+static void cmdStepRateTest(CommandQueueItem *c)
+{
+	motion_rate_t r;
+	uint32_t      period, ok = 0;
+	int           rate, i, steps, room = 0, pos = m1d->position();
+	boolean       enable = ((c->m_arg_mask & 1) && (c->m_arg0));
+	boolean       was_on = m1d->m_motorsEnabled;
+
+	if (m1d->isInMotion()) {
+		c->sendErrorText("Slider is in motion");
+		return;
+	}
+	if (enable) {
+		/* Free distance towards the farther soft limit */
+		room = ((MAX_POS - pos) > pos) ? (MAX_POS - pos) : -pos;
+		if ((pos < 0) || (pos > MAX_POS) || (room == 0)) {
+			c->sendErrorText("No room for the test");
+			return;
+		}
+	}
+	if (enable) m1d->motorsOn(); else m1d->motorsOff();
+	for (i = 0; i < (int)STEPRATE_LEVELS; ++i) {
+		rate   = g_rate_levels[i];
+		period = PLANNER_CLOCK / rate;
+		steps  = (rate / 5 > 500) ? rate / 5 : 500;
+		m1d->rateTest(period >> 1, steps, &r, room);
+		c->print(String(rate) + " steps/s: late=" + String(r.late) + ",max_interval=" + String(r.max_interval) + \
+			",max_isr=" + String(r.max_isr) + ",hperiod=" + String(period >> 1) + "\r\n");
+		if ((r.late) || (r.max_isr >= (period >> 1))) break;
+		ok = period;
+	}
+	if (was_on) m1d->motorsOn(); else m1d->motorsOff();
+	if (enable) {
+		/* Unramped runs may have stalled the motor */
+		g_pos_resync = 1;
+		sendEvent("!8 Err: Position not verified after the step rate test - home again\r\n");
+	}
+	if (ok == 0) {
+		c->sendErrorText("Step generator is too slow");
+		return;
+	}
+	planner_min_period = ok + (ok >> 2);
+	File f = LittleFS.open(STEPRATE_FILE, "w");
+	if (f) {
+		f.write((const uint8_t *)&planner_min_period, sizeof(planner_min_period));
+		f.close();
+	}
+	rate = PLANNER_CLOCK / planner_min_period;
+	c->print("sustainable=" + String(PLANNER_CLOCK / ok) + " steps/s,limit=" + String(rate) + \
+		" steps/s,min_period=" + String(planner_min_period) + "\r\n");
+#ifdef USE_RAMP
+	if (rate > RMAXIMUM_SPEED) {
+		c->print("ramp table limit=" + String(RMAXIMUM_SPEED) + " steps/s\r\n");
+		rate = RMAXIMUM_SPEED;
+	}
+#endif
+	for (i = 1; i <= 256; i <<= 1) {
+		c->print("microsteps=" + String(i) + ": " + String((rate * 60) / (200 * i)) + " rev/min\r\n");
+	}
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Reset step rate limit to the default (MIN_PERIOD) command.
+ */
+static void cmdStepRateReset(CommandQueueItem *c)
+{
+	planner_min_period = MIN_PERIOD;
+	LittleFS.remove(STEPRATE_FILE);
+	c->sendAck();
+}
+//====================================================================================
+
+/*!
+ * \brief Lost-step detection command (LS[,pause]) - pause the queue on mismatch, print counters.
+ */
+static void cmdLostSteps(CommandQueueItem *c)
+{
+	if (c->m_arg_mask & 1) m1d->m_lostPause = (c->m_arg0 != 0);
+	c->print("lost="+String(m1d->m_lostCount)+"\r\nlast="+String(m1d->m_lostLast)+"\r\npause="+String(m1d->m_lostPause)+"\r\nOK\r\n");
+}
+//====================================================================================
+
+#ifdef enc_a
+/*!
+ * \brief Encoder command (ENC[,cpr[,deadband[,limit]]]) - counts per motor revolution (0 - disabled,
+ * < 0 - reversed), end-of-move error left uncorrected and following error limit in [microsteps],
+ * prints the encoder status.
+ */
+static void cmdEncoder(CommandQueueItem *c)
+{
+	if (c->m_arg_mask & 1) {
+		m1d->setEncoder(200 * MICROSTEP_FINE, c->m_arg0, (c->m_arg_mask & 2) ? m1d->fromMicrosteps(c->m_arg1) : ENC_DEADBAND, \
+			(c->m_arg_mask & 4) ? m1d->fromMicrosteps(c->m_arg2) : ENC_FOLLOW_MAX);
+	}
+	c->print("encoder="+String(m1d->encoderPosition())+"\r\nerror="+String(m1d->encoderPosition() - m1d->position())+"\r\n" \
+		"corrections="+String(m1d->m_encCorrections)+"\r\nlast="+String(m1d->m_encLast)+"\r\nfaults="+String(m1d->m_encFaults)+"\r\n" \
+		"invalid="+String(m1d->encoderInvalid())+"\r\nOK\r\n");
+}
+//====================================================================================
+#endif
+
+/*!
+ * \brief Read driver register command (DR,register) - reply is sent when the transaction is done.
+ */
+static void cmdDriverRead(CommandQueueItem *c)
+{
+	Command *p = c->m_parent;
+
+	if (((c->m_arg_mask & 1) != 1) || (c->m_arg0 < 0) || (c->m_arg0 > 0x7f)) {
+		c->sendError();
+		return;
+	}
+	if (!driver.read(c->m_arg0, [p](bool ok, uint32_t v) {
+		if (ok) p->print("0x" + String(v, HEX) + "\r\nOK\r\n"); else p->print("!8 Err: Driver not responding\r\n");
+	})) {
+		c->sendErrorText("Driver busy");
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Run stored program command (PR,program).
+ */
+static void cmdProgramRun(CommandQueueItem *c)
+{
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	switch (FCmd->play(c->m_arg0, c->m_parent)) {
+		case FILE_PLAY_OK: c->sendAck(); break;
+		case FILE_PLAY_NO_FILE: c->sendErrorText("No such program"); break;
+		default: c->sendErrorText("Program does not match slider state"); break;
+	}
+}
+//====================================================================================
+
+/*!
+ * \brief Delete stored program command (PD,program).
+ */
+static void cmdProgramDelete(CommandQueueItem *c)
+{
+	bool text, binary;
+
+	if ((c->m_arg_mask & 1) != 1) {
+		c->sendError();
+		return;
+	}
+	if (FCmd->m_prog == c->m_arg0) FCmd->stopPlay();
+	text   = LittleFS.remove(FileCommand::programName(c->m_arg0));
+	binary = LittleFS.remove(FileCommand::programName(c->m_arg0, true));
+	if ((!text) && (!binary)) {
+		c->sendErrorText("No such program");
+		return;
+	}
+	c->sendAck();
+}
+//====================================================================================
+
 static void unrecognized(const char *command, Command *c) {c->print("!8 Err: Unknown command\r\n");}
 
 /*!
@@ -452,16 +1312,51 @@ static void makeCmdInterface()
 	CmdDB.addCommand("GTR",stepperMoveRelative, true);
 	CmdDB.addCommand("GTH",cmdHome, true);
 	CmdDB.addCommand("UM" ,stepperMoveUncondicional, true);
+	CmdDB.addCommand("BZ" ,stepperMoveCurve, true);
+	CmdDB.addCommand("BZC",cmdCurve, true);
+	CmdDB.addCommand("SMM",stepperMoveSpeedMap, true);
+	CmdDB.addCommand("SMC",cmdSpeedMapClear, true);
+	CmdDB.addCommand("SMK",cmdSpeedMapKnot, true);
+	CmdDB.addCommand("DW" ,stepperDwell, true);
+	CmdDB.addCommand("LB" ,stepperLoopBegin, true);
+	CmdDB.addCommand("LE" ,stepperLoopEnd, true);
 	CmdDB.addCommand("STP",stepperMoveStop);
+	CmdDB.addCommand("SST",stepperMoveSoftStop);
+	CmdDB.addCommand("PAU",stepperPause);
+	CmdDB.addCommand("RES",stepperResume);
+	CmdDB.addCommand("JOG",stepperJog);
 	/* Parameters */
 	CmdDB.addCommand("G90",cmdG90, true);
 	CmdDB.addCommand("C"  ,cmdCurrent, true);
+	CmdDB.addCommand("SC" ,cmdStealthChop, true);
+	CmdDB.addCommand("HC" ,cmdHoldCurrent, true);
+#ifdef DRIVER_TMC2209
+	CmdDB.addCommand("SG" ,cmdStallGuard, true);
+#endif
 	CmdDB.addCommand("S"  ,cmdSteps, true);
+	CmdDB.addCommand("SA" ,cmdAutoSteps, true);
+	CmdDB.addCommand("VA" ,cmdHybrid, true);
+	CmdDB.addCommand("FO" ,cmdOverride);
+	CmdDB.addCommand("SRT",cmdStepRateTest, true);
+	CmdDB.addCommand("SRR",cmdStepRateReset, true);
+	/* Stored programs */
+	CmdDB.addCommand("PR" ,cmdProgramRun);
+	CmdDB.addCommand("PS" ,[](CommandQueueItem *c){FCmd->stopPlay();c->sendAck();});
+	CmdDB.addCommand("PD" ,cmdProgramDelete);
+	CmdDB.addCommand("PL" ,[](CommandQueueItem *c){FCmd->list(c);});
 	/* Status */
 	CmdDB.addCommand("XX" ,[](CommandQueueItem *c){m1d->printStat(c);});
+	CmdDB.addCommand("DS" ,[](CommandQueueItem *c){driver.printStat(c);});
+	CmdDB.addCommand("DR" ,cmdDriverRead);
+	CmdDB.addCommand("LS" ,cmdLostSteps);
+#ifdef enc_a
+	CmdDB.addCommand("ENC",cmdEncoder, true);
+#endif
 	CmdDB.setDefaultHandler(unrecognized); // Handler for command that isn't matched (says "What?")
 
 	NCmd = new NetworkCommand(&CmdDB, NPORT);
 	HCmd = new HTTPCommand(&CmdDB);
+	FCmd = new FileCommand(&CmdDB);
+	FCmd->onBinary(programHeader, programSegment);
 }
 //====================================================================================
@@ -40,6 +40,25 @@ function startEvents()
 	}, false);
 }
 
+var jogTimer = null;
+
+function jogStart(dir)
+{
+	var cmd = "JOG," + (dir * $("#jog_speed").val()) + ",500";
+	jogStop();
+	sendCommand(cmd);
+	jogTimer = setInterval(function() { sendCommand(cmd); }, 200);
+}
+
+function jogStop()
+{
+	if (jogTimer) {
+		clearInterval(jogTimer);
+		jogTimer = null;
+		sendCommand("JOG,0");
+	}
+}
+
 $(document).ready(function()
 {
 	startEvents();
@@ -51,7 +70,14 @@ $(document).ready(function()
 	$("#but_right20").click(function(){ sendCommand("MR,12000,20");});
 	$("#but_left20").click(function(){ sendCommand("MR,12000,-20");});
 	$("#but_right10").click(function(){ sendCommand("MR,6000,10");});
+	$("#but_jog_left").on("mousedown touchstart", function(){ jogStart(-1);});
+	$("#but_jog_right").on("mousedown touchstart", function(){ jogStart(1);});
+	$("#but_jog_left, #but_jog_right").on("mouseup mouseleave touchend", function(){ jogStop();});
 	$("#but_stop").click(function(){ sendCommand("STP");});
+	$("#but_soft_stop").click(function(){ sendCommand("SST");});
+	$("#but_pause").click(function(){ sendCommand("PAU");});
+	$("#but_resume").click(function(){ sendCommand("RES");});
 	$("#but_home").click(function(){ sendCommand("MH");});
+	$("#override").on("change", function(){ sendCommand("FO," + $(this).val());});
 	$("#but_send").click(function(){ sendCommand($("#cmd").val());});
 });
\ No newline at end of file